@@ -0,0 +1,880 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <functional>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "Game.h"
+#include "CommandTable.h"
+#include "OutputSink.h"
+#include "WorldLoader.h"
+#include "WorldGenerator.h"
+#include "SymbolTable.h"
+#include "Snapshot.h"
+#include "WorldDefinition.h"
+#include <sstream>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <algorithm>
+#include "SharedWorld.h"
+#include "ShardRuntime.h"
+#include "EventLog.h"
+#include "EventReplayer.h"
+#include "Random.h"
+#include <malloc.h> // For mallinfo2, to measure the heap
+
+/*
+ * Microbenchmarks for GVZork, for checking the cost of the
+ * game's internals in isolation (the replay driver in Replay.cpp
+ * measures whole commands).
+ *
+ * Usage:
+ * benchmark <name>
+ *  commands  command lookup: the compile-time COMMAND_TABLE against
+ *            a std::map of std::function like the game used to build
+ *  look      printing a large room: the cached text from WorldState::render
+ *            against formatting the room from scratch every time
+ *  world     loading, copying, and freeing a large text world
+ *  create_world  heap allocations made building and freeing the built-in world
+ *  crowd     commands that find an item or NPC by name, in a room of 10k items and 10k NPCs
+ *  scale     every kind of command in generated worlds of 10, 10k, and 1M rooms,
+ *            to catch commands whose cost grows with the size of the world
+ *  snapshot  saving and restoring a game of a generated 1M room world (see Snapshot.h)
+ *  fork      forking a game in a generated 1M room world 100k times (see Game::fork),
+ *            against deep copying the world's locations once
+ *  sessions  memory and time for 10k games playing at once in one generated 100k room
+ *            world, all sharing its WorldDefinition
+ *  coroutines  memory for 10k game loops suspended on one thread (see Game::play_async),
+ *            and the time to feed one a line, against running the command directly
+ *  shared    stress test of many players in one SharedWorld on 1 to (at least) 4 threads,
+ *            spread over 10k rooms and then crowded into 4, checking afterwards that
+ *            every item is in exactly one place
+ *  shards    10k bots in a generated 1M room world on a ShardRuntime of 1 to (at least) 4
+ *            shards, with the same check afterwards
+ *  events    playing 1M turns in a generated 100k room world with and without recording
+ *            an EventLog, then seeking an EventReplayer to random turns, with checkpoints
+ *            every 1000 turns and with only the one at the start
+ */
+
+// Number of heap allocations made so far on this thread (the benchmarks that count them are single threaded)
+static thread_local unsigned long long allocationCount = 0;
+
+// Count every allocation made through operator new and new[], with the deletes that match them.
+// They're all kept out of line, or GCC sees malloc() and free() paired with the other kind of
+// call where one is inlined, and warns they don't match.
+[[gnu::noinline]] void* operator new(std::size_t size){
+	allocationCount++;
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr){
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+[[gnu::noinline]] void* operator new[](std::size_t size){
+	return operator new(size);
+}
+
+[[gnu::noinline]] void operator delete(void* memory) noexcept{
+	std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept{
+	std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete[](void* memory) noexcept{
+	std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete[](void* memory, std::size_t) noexcept{
+	std::free(memory);
+}
+
+// Keeps results alive so the compiler can't optimize the measured work away
+static volatile unsigned long long benchmarkSink = 0;
+
+// Run work(i) for i in [0, iterations) and print the average time per call
+template <typename Work>
+static void measure(const std::string& label, long iterations, Work work){
+	unsigned long long total = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (long i = 0; i < iterations; i++){
+		total += work(i);
+	}
+	auto stop = std::chrono::steady_clock::now();
+	benchmarkSink = benchmarkSink + total;
+	double nanoseconds = std::chrono::duration<double, std::nano>(stop - start).count();
+	std::cout << label << ": " << nanoseconds / iterations << " ns/op" << std::endl;
+}
+
+// Look up every command name (plus a few misses) in both command tables
+static void benchmark_commands(){
+	// The names users type: every command, plus some that don't exist
+	std::vector<std::string> inputs;
+	for (const Command& command : COMMAND_TABLE){
+		inputs.emplace_back(command.name);
+	}
+	inputs.push_back("dance");
+	inputs.push_back("Take");
+	inputs.push_back("xyzzy");
+	std::vector<std::string_view> views(inputs.begin(), inputs.end());
+
+	// The map the game used to build in setup_commands
+	std::map<std::string, std::function<void(std::span<const std::string_view> target)>> commandMap;
+	for (const Command& command : COMMAND_TABLE){
+		commandMap[std::string(command.name)] = [](std::span<const std::string_view> target){ benchmarkSink = benchmarkSink + target.size(); };
+	}
+
+	const long iterations = 20000000;
+	int count = inputs.size();
+	// The old path split each word into a std::string before looking it up
+	measure("std::map<std::string, std::function> lookup", iterations, [&](long i){
+		std::string command(views[i % count]);
+		auto it = commandMap.find(command);
+		return (unsigned long long)(it != commandMap.end());
+	});
+	measure("COMMAND_TABLE lookup", iterations, [&](long i){
+		return (unsigned long long)(find_command(views[i % count]) != nullptr);
+	});
+}
+
+// Print a room with many items and NPCs, with and without the cached look text
+static void benchmark_look(){
+	World world;
+	world.locations.emplace_back("Warehouse", "A huge room full of things.");
+	world.locations.emplace_back("Loading dock", "Trucks come and go.");
+	for (int i = 0; i < 200; i++){
+		world.locations[0].add_item(Item("Crate " + std::to_string(i), "A wooden crate with something inside.", i % 3 == 0 ? 0 : 10 + i, 1.5f + i % 7), world.items);
+	}
+	for (int n = 0; n < 20; n++){
+		world.locations[0].add_npc(NPC("Worker " + std::to_string(n), "Someone moving crates around."));
+	}
+	world.graph.add_edge(0, "North", 1);
+	world.graph.add_edge(0, "South", 1);
+	world.graph.add_edge(1, "South", 0);
+	world.graph.build(world.locations.size());
+	WorldDefinition definition(world);
+	WorldState state = definition.start_state();
+
+	NullSink sink;
+	std::ostream& out = sink.stream();
+	const long iterations = 200000;
+	measure("look, formatted every time", iterations, [&](long i){
+		world.locations[0].print(out, state.items(0), world.items);
+		world.graph.print_directions(out, 0, world.locations, state);
+		out << "\n";
+		return sink.bytes();
+	});
+	measure("look, cached text", iterations, [&](long i){
+		const std::string& text = state.render(0, definition);
+		out.write(text.data(), text.size());
+		return sink.bytes();
+	});
+}
+
+// Time one call of work() and print it
+template <typename Work>
+static void time_once(const std::string& label, Work work){
+	auto start = std::chrono::steady_clock::now();
+	work();
+	auto stop = std::chrono::steady_clock::now();
+	std::cout << label << ": " << std::chrono::duration<double, std::milli>(stop - start).count() << " ms" << std::endl;
+}
+
+// Load a world of 100k rooms from text, copy it (as every Game does), and free both
+static void benchmark_world(){
+	const int rooms = 100000;
+	std::ostringstream text;
+	for (int r = 0; r < rooms; r++){
+		text << "location|room" << r << "|Room " << r << "|A plain room, number " << r << " of many, with nothing special about it.\n";
+		for (int i = 0; i < 3; i++){
+			text << "item|Thing " << r % 1000 << "-" << i << "|Something lying on the floor of room " << r << ".|" << (i == 0 ? 25 : 0) << "|1.5\n";
+		}
+		text << "npc|Person " << r % 1000 << "|Someone who lives in room " << r << ".\n";
+		text << "message|Hello from room " << r << ", traveller.\n";
+		text << "message|Go away, I'm busy in room " << r << ".\n";
+		text << "exit|room" << r << "|North|room" << (r + 1) % rooms << "\n";
+		text << "exit|room" << r << "|South|room" << (r + rooms - 1) % rooms << "\n";
+	}
+	text << "elf|room0\nsecurity|room1\n";
+	std::string definition = text.str();
+
+	World* world = nullptr;
+	World* copy = nullptr;
+	time_once("load 100k rooms", [&](){
+		std::istringstream input(definition);
+		world = new World(WorldLoader::load_text(input));
+	});
+	time_once("copy world", [&](){
+		copy = new World(*world);
+	});
+	time_once("free copy", [&](){
+		delete copy;
+	});
+	time_once("free world", [&](){
+		delete world;
+	});
+}
+
+// Count the allocations made by Game::create_world, and time it
+static void benchmark_create_world(){
+	Game::create_world(); // Warm up, so names are already in the SymbolTable
+	unsigned long long before = allocationCount;
+	World* world = new World(Game::create_world());
+	std::cout << "create_world allocations: " << allocationCount - before << std::endl;
+	delete world;
+	measure("create_world and free it", 100000, [](long i){
+		World world = Game::create_world();
+		return (unsigned long long)world.locations.size();
+	});
+}
+
+// Find items and NPCs by name in a room crowded with them
+static void benchmark_crowd(){
+	const int entities = 10000;
+	World world;
+	world.locations.emplace_back("Stadium", "Everyone is here, and they all brought something.");
+	world.locations.emplace_back("Parking lot", "Full.");
+	for (int i = 0; i < entities; i++){
+		world.locations[0].emplace_item(world.items, "Seat cushion " + std::to_string(i), "A foam seat cushion.", 0, 0.5f);
+	}
+	for (int n = 0; n < entities; n++){
+		world.locations[0].emplace_npc("Fan " + std::to_string(n), "A fan in team colors.").addMessage("Go Lakers!");
+	}
+	world.locations[0].emplace_item(world.items, "Foam finger", "It says WE'RE NUMBER 1.", 0, 0.5f);
+	world.graph.add_edge(0, "South", 1);
+	world.graph.add_edge(1, "North", 0);
+	world.graph.build(world.locations.size());
+	world.elfLocation = 1;
+	world.securityLocation = 1;
+
+	NullSink sink;
+	Game game(world, 1, sink.stream());
+	if (game.current_location() != 0){
+		game.run_command("go North");
+	}
+	// The last ones added, which a scan from the front reaches last
+	std::string take = "take Seat cushion " + std::to_string(entities - 1);
+	std::string give = "give Seat cushion " + std::to_string(entities - 1);
+	std::string talk = "talk Fan " + std::to_string(entities - 1);
+	std::string buy = "buy Fan " + std::to_string(entities - 1);
+	const long iterations = 20000;
+	measure("take and give", iterations, [&](long i){
+		game.run_command(i % 2 == 0 ? take : give);
+		return sink.bytes();
+	});
+	measure("take, missing item", iterations, [&](long i){
+		game.run_command("take Seat cushion -1");
+		return sink.bytes();
+	});
+	// Targets that don't match exactly, found through the SymbolTable's NameTrie
+	measure("take and give, any capitalization", iterations, [&](long i){
+		game.run_command(i % 2 == 0 ? "take SEAT CUSHION 9999" : "give seat cushion 9999");
+		return sink.bytes();
+	});
+	measure("take and give, prefix", iterations, [&](long i){
+		game.run_command(i % 2 == 0 ? "take foam f" : "give foam f");
+		return sink.bytes();
+	});
+	measure("take and give, one typo", iterations, [&](long i){
+		game.run_command(i % 2 == 0 ? "take Seat cushon 9999" : "give Seat cushoin 9999");
+		return sink.bytes();
+	});
+	measure("talk", iterations, [&](long i){
+		game.run_command(talk);
+		return sink.bytes();
+	});
+	measure("meet, missing NPC", iterations, [&](long i){
+		game.run_command("meet Fan -1");
+		return sink.bytes();
+	});
+	measure("buy, from someone not selling", iterations, [&](long i){
+		game.run_command(buy);
+		return sink.bytes();
+	});
+}
+
+// Time each kind of command in generated worlds of growing size
+static void benchmark_scale(){
+	const int sizes[] = {10, 10000, 1000000};
+	const long iterations = 200000;
+	for (int rooms : sizes){
+		std::cout << "--- " << rooms << " rooms ---" << std::endl;
+		GeneratorOptions options;
+		options.rooms = rooms;
+		World world;
+		time_once("generate", [&](){
+			world = WorldGenerator::generate(options);
+		});
+		NullSink sink;
+		std::shared_ptr<const WorldDefinition> definition;
+		time_once("define the world (once for every game)", [&](){
+			definition = std::make_shared<const WorldDefinition>(world);
+		});
+		Game* game = nullptr;
+		time_once("start a game", [&](){
+			game = new Game(definition, 1, sink.stream());
+		});
+		// Step off the Elf's room, where giving food away would feed the Elf
+		if (game->current_location() == world.elfLocation){
+			game->run_command("go North");
+		}
+		int here = game->current_location();
+		// Targets that are in the player's room (see WorldGenerator.h for where they are)
+		std::string take = "take " + SymbolTable::global().name(world.items.name_id(here * options.itemsPerRoom));
+		std::string give = "give " + SymbolTable::global().name(world.items.name_id(here * options.itemsPerRoom));
+		std::string talk = "talk " + std::string(WorldGenerator::npc_name(here, 0));
+		std::string meet = "meet " + std::string(WorldGenerator::npc_name(here, 0));
+		std::string buy = "buy " + std::string(WorldGenerator::npc_name(here, 0));
+
+		measure("go (there and back)", iterations, [&](long i){
+			game->run_command(i % 2 == 0 ? "go North" : "go South");
+			return sink.bytes();
+		});
+		measure("look", iterations, [&](long i){
+			game->run_command("look");
+			return sink.bytes();
+		});
+		measure("take and give", iterations, [&](long i){
+			game->run_command(i % 2 == 0 ? take : give);
+			return sink.bytes();
+		});
+		measure("take, missing item", iterations, [&](long i){
+			game->run_command("take Nothing at all");
+			return sink.bytes();
+		});
+		measure("talk", iterations, [&](long i){
+			game->run_command(talk);
+			return sink.bytes();
+		});
+		measure("meet", iterations, [&](long i){
+			game->run_command(meet);
+			return sink.bytes();
+		});
+		measure("buy, from someone not selling", iterations, [&](long i){
+			game->run_command(buy);
+			return sink.bytes();
+		});
+		measure("inventory", iterations, [&](long i){
+			game->run_command("inventory");
+			return sink.bytes();
+		});
+		measure("invalid command", iterations, [&](long i){
+			game->run_command("dance");
+			return sink.bytes();
+		});
+		time_once("end the game (free its changes)", [&](){
+			delete game;
+		});
+	}
+}
+
+// Save and restore a game in a world of 1M rooms, after playing it for a while
+static void benchmark_snapshot(){
+	GeneratorOptions options;
+	options.rooms = 1000000;
+	World world = WorldGenerator::generate(options);
+	std::shared_ptr<const WorldDefinition> definition = std::make_shared<const WorldDefinition>(world);
+	NullSink sink;
+	Game game(definition, 1, sink.stream());
+	// Walk around the ring taking things, so there's state to save besides the start
+	for (int step = 0; step < 10000; step++){
+		int here = game.current_location();
+		game.run_command("take " + SymbolTable::global().name(world.items.name_id(here * options.itemsPerRoom)));
+		game.run_command("talk " + std::string(WorldGenerator::npc_name(here, 0)));
+		game.run_command("go North");
+	}
+	std::string bytes;
+	time_once("save", [&](){
+		Snapshot::save(game, bytes);
+	});
+	std::cout << "snapshot size: " << bytes.size() << " bytes" << std::endl;
+	measure("save again (buffer reused)", 20, [&](long i){
+		Snapshot::save(game, bytes);
+		return (unsigned long long)bytes.size();
+	});
+	Game* restored = new Game(definition, 2, sink.stream());
+	time_once("restore into a new game", [&](){
+		Snapshot::restore(*restored, bytes);
+	});
+	measure("restore again", 20, [&](long i){
+		Snapshot::restore(*restored, bytes);
+		return (unsigned long long)restored->current_location();
+	});
+	std::string again;
+	Snapshot::save(*restored, again);
+	std::cout << "restored game saves the same snapshot: " << (again == bytes ? "yes" : "NO") << std::endl;
+	delete restored;
+
+	// A world built in code can have an NPC without messages (loaded ones can't), which has to round trip too
+	World silent = Game::create_world();
+	silent.locations[0].emplace_npc("Mime", "They don't say a word.");
+	std::shared_ptr<const WorldDefinition> silentDefinition = std::make_shared<const WorldDefinition>(std::move(silent));
+	Game player(silentDefinition, 1, sink.stream());
+	Game restoredPlayer(silentDefinition, 2, sink.stream());
+	Snapshot::save(player, bytes);
+	try {
+		Snapshot::restore(restoredPlayer, bytes);
+		Snapshot::save(restoredPlayer, again);
+		std::cout << "restored game with a silent NPC saves the same snapshot: " << (again == bytes ? "yes" : "NO") << std::endl;
+	} catch (const std::invalid_argument& e){
+		std::cout << "restored game with a silent NPC saves the same snapshot: NO (" << e.what() << ")" << std::endl;
+	}
+}
+
+// Fork a game part way through, and play a turn in each fork
+static void benchmark_fork(){
+	GeneratorOptions options;
+	options.rooms = 1000000;
+	World world = WorldGenerator::generate(options);
+	NullSink sink;
+	Game game(world, 1, sink.stream());
+	if (game.current_location() == world.elfLocation){
+		game.run_command("go North");
+	}
+	for (int step = 0; step < 100; step++){
+		game.run_command("go North");
+	}
+	int here = game.current_location();
+	std::string take = "take " + SymbolTable::global().name(world.items.name_id(here * options.itemsPerRoom));
+	std::string talk = "talk " + std::string(WorldGenerator::npc_name(here, 0));
+
+	// What a fork used to cost: copying every location
+	std::vector<Location> flat;
+	flat.reserve(world.locations.size());
+	for (const Location& location : world.locations){
+		flat.push_back(location);
+	}
+	time_once("deep copy of the locations", [&](){
+		std::vector<Location> copy(flat);
+		benchmarkSink = benchmarkSink + copy.size();
+	});
+
+	const long forks = 100000;
+	unsigned long long before = allocationCount;
+	measure("fork and free", forks, [&](long i){
+		Game fork = game.fork(sink.stream());
+		return (unsigned long long)fork.current_location();
+	});
+	std::cout << "allocations per fork: " << (double)(allocationCount - before) / forks << std::endl;
+	measure("fork, take, and free", forks, [&](long i){
+		Game fork = game.fork(sink.stream());
+		fork.run_command(take);
+		return sink.bytes();
+	});
+	measure("fork, go, talk, look, and free", forks, [&](long i){
+		Game fork = game.fork(sink.stream());
+		fork.run_command("go North");
+		fork.run_command(talk);
+		fork.run_command("look");
+		return sink.bytes();
+	});
+	// The forks changed nothing in the original, so the item is still there to take
+	MemorySink memory;
+	Game check = game.fork(memory.stream());
+	check.run_command(take);
+	memory.stream() << std::flush;
+	std::cout << "original still has the item to take: " << (memory.str().empty() ? "yes" : "NO") << std::endl;
+}
+
+// Bytes in use on the heap (including large blocks malloc maps on their own)
+static double heap_megabytes(){
+	struct mallinfo2 info = mallinfo2();
+	return (double)(info.uordblks + info.hblkhd) / (1024 * 1024);
+}
+
+// Keep many games going at once in one world, and measure the memory each one adds
+static void benchmark_sessions(){
+	const int sessions = 10000;
+	const int turns = 10; // Each a take, talk, go, and look
+	GeneratorOptions options;
+	options.rooms = 100000;
+	double empty = heap_megabytes();
+	World world = WorldGenerator::generate(options);
+	std::shared_ptr<const WorldDefinition> definition = std::make_shared<const WorldDefinition>(world);
+	double defined = heap_megabytes();
+	std::cout << "world and its definition: " << defined - empty << " MB" << std::endl;
+
+	NullSink sink;
+	std::vector<std::unique_ptr<Game>> games;
+	games.reserve(sessions);
+	time_once("start 10k games", [&](){
+		for (int s = 0; s < sessions; s++){
+			games.emplace_back(new Game(definition, s, sink.stream()));
+		}
+	});
+	double started = heap_megabytes();
+	std::cout << "per game, started: " << (started - defined) * 1024 * 1024 / sessions << " bytes" << std::endl;
+	time_once("play 10 turns in each game", [&](){
+		for (std::unique_ptr<Game>& game : games){
+			for (int turn = 0; turn < turns; turn++){
+				int here = game->current_location();
+				game->run_command("take " + SymbolTable::global().name(world.items.name_id(here * options.itemsPerRoom)));
+				game->run_command("talk " + std::string(WorldGenerator::npc_name(here, 0)));
+				game->run_command("go North");
+				game->run_command("look");
+			}
+		}
+	});
+	double played = heap_megabytes();
+	std::cout << "per game, after 10 turns: " << (played - defined) * 1024 * 1024 / sessions << " bytes" << std::endl;
+	std::cout << "10k games in all: " << played - defined << " MB, next to " << defined - empty << " MB for the world they share" << std::endl;
+	time_once("end every game", [&](){
+		games.clear();
+	});
+}
+
+// Keep many game loops suspended on one thread (see GameLoop.h), and feed each a line in turn
+static void benchmark_coroutines(){
+	const int sessions = 10000;
+	const int rounds = 20;
+	const std::vector<std::string> script = {"look", "go North", "talk Professor", "inventory", "go South",
+		"meet Employee", "go East", "look", "go West", "talk Elf"};
+	std::shared_ptr<const WorldDefinition> definition = std::make_shared<const WorldDefinition>(Game::create_world());
+	// A player is what a server keeps per session: a sink for the output, the game, and its loop
+	struct Player{
+		MemorySink output;
+		Game game;
+		std::optional<GameLoop> loop;
+		Player(std::shared_ptr<const WorldDefinition> world, std::uint64_t seed) : game(std::move(world), seed, output.stream()){}
+	};
+	std::vector<std::unique_ptr<Player>> players;
+	players.reserve(sessions);
+	double empty = heap_megabytes();
+	for (int s = 0; s < sessions; s++){
+		players.emplace_back(new Player(definition, s));
+	}
+	double made = heap_megabytes();
+	std::cout << "per session, game and sink: " << (made - empty) * 1024 * 1024 / sessions << " bytes" << std::endl;
+	unsigned long long before = allocationCount;
+	time_once("start 10k game loops", [&](){
+		for (std::unique_ptr<Player>& player : players){
+			player->loop.emplace(player->game.play_async());
+			player->output.clear(); // As if the welcome was sent
+		}
+	});
+	double started = heap_megabytes();
+	std::cout << "per session, started loop (its frame, and the output buffer the welcome grew): "
+		<< (started - made) * 1024 * 1024 / sessions << " bytes, " << (double)(allocationCount - before) / sessions << " allocations" << std::endl;
+	// Round robin, the way one scheduler thread would go through sessions with a line waiting.
+	// One pass over the script first, so neither timing includes rendering rooms the first time
+	for (long i = 0; i < static_cast<long>(sessions * script.size()); i++){
+		Player& player = *players[i % sessions];
+		player.loop->feed(script[(i / sessions + i % sessions) % script.size()]);
+		player.output.clear();
+	}
+	double warmed = heap_megabytes();
+	std::cout << "per session, after a pass over the script: " << (warmed - empty) * 1024 * 1024 / sessions << " bytes in all" << std::endl;
+	measure("feed a line to a suspended loop", (long)sessions * rounds, [&](long i){
+		Player& player = *players[i % sessions];
+		player.loop->feed(script[(i / sessions + i % sessions) % script.size()]);
+		std::size_t bytes = player.output.str().size();
+		player.output.clear();
+		return bytes;
+	});
+	measure("run the same command directly", (long)sessions * rounds, [&](long i){
+		Player& player = *players[i % sessions];
+		player.game.run_command(script[(i / sessions + i % sessions) % script.size()]);
+		player.game.prompt();
+		std::size_t bytes = player.output.str().size();
+		player.output.clear();
+		return bytes;
+	});
+	int ended = 0;
+	for (std::unique_ptr<Player>& player : players){
+		ended += player->loop->done();
+	}
+	std::cout << "loops ended early: " << ended << std::endl;
+}
+
+// Play 100 players per thread in one SharedWorld, each taking an item, carrying it through
+// an exit and dropping it, looking, and talking, then check that every item ended up in one place
+static void stress_shared(const std::string& label, int rooms, int threadCount){
+	const int playersPerThread = 100;
+	const int turns = 200; // Of 5 commands each
+	GeneratorOptions options;
+	options.rooms = rooms;
+	World world = WorldGenerator::generate(options);
+	// Every command a player can send in each room, made up front so the threads don't build strings
+	std::vector<std::vector<std::string>> takes(rooms), gives(rooms);
+	std::vector<std::string> talks(rooms);
+	for (int r = 0; r < rooms; r++){
+		for (int i = 0; i < options.itemsPerRoom; i++){
+			std::string name = SymbolTable::global().name(world.items.name_id(r * options.itemsPerRoom + i));
+			takes[r].push_back("take " + name);
+			gives[r].push_back("give " + name);
+		}
+		talks[r] = "talk " + std::string(WorldGenerator::npc_name(r, 0));
+	}
+	const std::vector<std::string> moves = {"go North", "go South", "go East", "go West"};
+	std::shared_ptr<SharedWorld> shared = std::make_shared<SharedWorld>(std::make_shared<const WorldDefinition>(world));
+	std::vector<std::unique_ptr<NullSink>> sinks;
+	std::vector<std::unique_ptr<Game>> players;
+	for (int t = 0; t < threadCount; t++){
+		sinks.emplace_back(new NullSink());
+		for (int p = 0; p < playersPerThread; p++){
+			players.emplace_back(new Game(shared, t * playersPerThread + p, sinks[t]->stream()));
+		}
+	}
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; t++){
+		threads.emplace_back([&, t](){
+			Random rng(t + 1);
+			for (int turn = 0; turn < turns; turn++){
+				for (int p = t * playersPerThread; p < (t + 1) * playersPerThread; p++){
+					Game& player = *players[p];
+					int here = player.current_location();
+					int item = rng.below(options.itemsPerRoom);
+					// Items wander off from the room they started in, and other players take them, so this can miss
+					player.run_command(takes[here][item]);
+					player.run_command(moves[rng.below(moves.size())]);
+					player.run_command(gives[here][item]);
+					player.run_command("look");
+					player.run_command(talks[player.current_location()]);
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads){
+		thread.join();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::vector<const Game*> everyone;
+	for (const std::unique_ptr<Game>& player : players){
+		everyone.push_back(player.get());
+	}
+	long commands = (long)threadCount * playersPerThread * turns * 5;
+	std::cout << label << ", " << threadCount << " threads: " << commands / seconds << " commands/second, "
+		<< shared->misplaced_items(everyone) << " items misplaced" << std::endl;
+}
+
+static void benchmark_shared(){
+	int cores = std::max(1u, std::thread::hardware_concurrency());
+	std::cout << cores << " CPU cores" << std::endl;
+	for (int threads = 1; threads <= std::max(4, cores); threads *= 2){
+		stress_shared("10k rooms", 10000, threads);
+	}
+	for (int threads = 1; threads <= std::max(4, cores); threads *= 2){
+		stress_shared("4 rooms", 4, threads);
+	}
+}
+
+// Play bots in a generated world on a ShardRuntime with the given number of shards. Each bot sends
+// its next line from the turn function, so the shards keep busy without any other thread feeding them
+static void run_shards(const World& world, const GeneratorOptions& options, int shardCount){
+	const int bots = 10000;
+	const int linesPerBot = 100;
+	// What each bot is doing, only used by the shard that has the bot
+	struct Bot{
+		int sent = 0;
+		int home = 0; // Where the bot took its item
+		int item = 0; // Which of home's items it took
+		Random rng;
+		Bot(std::uint64_t seed) : rng(seed){}
+	};
+	std::vector<Bot> state;
+	for (int b = 0; b < bots; b++){
+		state.emplace_back(b + 1);
+	}
+	const std::vector<std::string> moves = {"go North", "go South", "go East", "go West"};
+	auto item_name = [&](int room, int item){
+		return SymbolTable::global().name(world.items.name_id(room * options.itemsPerRoom + item));
+	};
+	// The bot's next line: take an item, carry it through an exit, drop it, look, and talk
+	auto next_line = [&](Bot& bot, Game& game) -> std::string{
+		switch (bot.sent++ % 5){
+			case 0:
+				bot.home = game.current_location();
+				bot.item = bot.rng.below(options.itemsPerRoom);
+				return "take " + item_name(bot.home, bot.item);
+			case 1:
+				return moves[bot.rng.below(moves.size())];
+			case 2:
+				return "give " + item_name(bot.home, bot.item);
+			case 3:
+				return "look";
+			default:
+				return "talk " + std::string(WorldGenerator::npc_name(game.current_location(), 0));
+		}
+	};
+	std::atomic<int> finished(0);
+	ShardRuntime* runtime = nullptr;
+	std::vector<std::unique_ptr<NullSink>> sinks; // One per bot, since a bot's shard can change between lines
+	for (int b = 0; b < bots; b++){
+		sinks.push_back(std::make_unique<NullSink>());
+	}
+	auto start = std::chrono::steady_clock::now();
+	ShardRuntime shards(std::make_shared<const WorldDefinition>(world), shardCount, [&](ShardRuntime::Player& player){
+		Bot& bot = state[player.id()];
+		if (bot.sent < linesPerBot){
+			runtime->submit(player, next_line(bot, player.game()));
+		} else if (finished.fetch_add(1) + 1 == bots){
+			finished.notify_one();
+		}
+	});
+	runtime = &shards;
+	std::vector<ShardRuntime::Player*> players;
+	for (int b = 0; b < bots; b++){
+		players.push_back(&shards.join(b, sinks[b]->stream()));
+	}
+	double setup = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	start = std::chrono::steady_clock::now();
+	for (ShardRuntime::Player* player : players){
+		shards.submit(*player, next_line(state[player->id()], player->game()));
+	}
+	for (int done = finished.load(); done < bots; done = finished.load()){
+		finished.wait(done);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << shards.shard_count() << " shards: " << shards.commands() / seconds << " commands/second, "
+		<< shards.handoffs() << " handoffs between shards, " << shards.misplaced_items() << " items misplaced ("
+		<< setup << " s to set up)" << std::endl;
+}
+
+static void benchmark_shards(){
+	int cores = std::max(1u, std::thread::hardware_concurrency());
+	std::cout << cores << " CPU cores" << std::endl;
+	GeneratorOptions options;
+	options.rooms = 1000000;
+	World world = WorldGenerator::generate(options);
+	for (int shards = 1; shards <= std::max(4, cores); shards *= 2){
+		run_shards(world, options, shards);
+	}
+}
+
+// Record 1M turns of a game, then rebuild it at random turns from the log
+static void benchmark_events(){
+	const int turns = 1000000;
+	GeneratorOptions options;
+	options.rooms = 100000;
+	World world = WorldGenerator::generate(options);
+	std::shared_ptr<const WorldDefinition> definition = std::make_shared<const WorldDefinition>(world);
+	// Every command the player sends in each room, made up front so building strings isn't timed
+	std::vector<std::vector<std::string>> takes(options.rooms), gives(options.rooms);
+	std::vector<std::string> talks(options.rooms);
+	for (int r = 0; r < options.rooms; r++){
+		for (int i = 0; i < options.itemsPerRoom; i++){
+			std::string name = SymbolTable::global().name(world.items.name_id(r * options.itemsPerRoom + i));
+			takes[r].push_back("take " + name);
+			gives[r].push_back("give " + name);
+		}
+		talks[r] = "talk " + std::string(WorldGenerator::npc_name(r, 0));
+	}
+	const std::vector<std::string> moves = {"go North", "go South", "go East", "go West"};
+	NullSink sink;
+	// Play the same game every time: take an item, carry it through an exit, drop it, look, and talk.
+	// after(t) is called once the game is at turn t
+	auto play = [&](Game& game, const std::function<void(int)>& after){
+		Random rng(1);
+		int here = 0;
+		int item = 0;
+		for (int t = 0; t < turns; t++){
+			switch (t % 5){
+				case 0:
+					here = game.current_location();
+					item = rng.below(options.itemsPerRoom);
+					game.run_command(takes[here][item]);
+					break;
+				case 1:
+					game.run_command(moves[rng.below(moves.size())]);
+					break;
+				case 2:
+					game.run_command(gives[here][item]);
+					break;
+				case 3:
+					game.run_command("look");
+					break;
+				default:
+					game.run_command(talks[game.current_location()]);
+			}
+			after(t + 1);
+		}
+	};
+	auto nothing = [](int){};
+	Game plain(definition, 1, sink.stream());
+	auto start = std::chrono::steady_clock::now();
+	play(plain, nothing);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "not recording: " << turns / seconds << " turns/second" << std::endl;
+	EventLog log(*definition);
+	Game recorded(definition, 1, sink.stream());
+	recorded.record_events(&log);
+	start = std::chrono::steady_clock::now();
+	play(recorded, nothing);
+	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "recording: " << turns / seconds << " turns/second, " << (double)log.data().size() / turns
+		<< " bytes per turn (" << log.data().size() << " bytes, with a " << options.rooms << " room snapshot at the start)" << std::endl;
+
+	// Snapshots of the game at some turns, to check the rebuilt games against
+	std::vector<int> checked = {0, 1, 999, 1000, 1001, 123457, 500000, 999999, turns};
+	std::map<int, std::string> expected;
+	Game again(definition, 1, sink.stream());
+	Snapshot::save(again, expected[0]);
+	play(again, [&](int t){
+		if (std::find(checked.begin(), checked.end(), t) != checked.end()){
+			Snapshot::save(again, expected[t]);
+		}
+	});
+
+	Random rng(2);
+	for (int interval : {1000, turns}){
+		std::string label = (interval == turns) ? "no checkpoints after the start" : "a checkpoint every " + std::to_string(interval) + " turns";
+		std::optional<EventReplayer> replayer;
+		start = std::chrono::steady_clock::now();
+		replayer.emplace(definition, std::string(log.data()), interval);
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << label << ": " << seconds << " s to replay and check the whole log" << std::endl;
+		const int seeks = (interval == turns) ? 20 : 1000;
+		measure(label + ", seek to a random turn", seeks, [&](long i){
+			return (unsigned long long)replayer->seek(rng.below(turns + 1)).current_location();
+		});
+		bool same = true;
+		std::string bytes;
+		for (int t : checked){
+			Snapshot::save(replayer->seek(t), bytes);
+			same = same && bytes == expected[t];
+		}
+		std::cout << label << ", rebuilt games match the recorded game: " << (same ? "yes" : "NO") << std::endl;
+	}
+}
+
+int main(int argc, char** argv){
+	std::string name = (argc > 1) ? argv[1] : "";
+	if (name == "commands"){
+		benchmark_commands();
+	} else if (name == "look"){
+		benchmark_look();
+	} else if (name == "world"){
+		benchmark_world();
+	} else if (name == "create_world"){
+		benchmark_create_world();
+	} else if (name == "crowd"){
+		benchmark_crowd();
+	} else if (name == "scale"){
+		benchmark_scale();
+	} else if (name == "snapshot"){
+		benchmark_snapshot();
+	} else if (name == "fork"){
+		benchmark_fork();
+	} else if (name == "sessions"){
+		benchmark_sessions();
+	} else if (name == "coroutines"){
+		benchmark_coroutines();
+	} else if (name == "shared"){
+		benchmark_shared();
+	} else if (name == "shards"){
+		benchmark_shards();
+	} else if (name == "events"){
+		benchmark_events();
+	} else {
+		std::cerr << "Usage: " << argv[0] << " <commands|look|world|create_world|crowd|scale|snapshot|fork|sessions|coroutines|shared|shards|events>" << std::endl;
+		return 2;
+	}
+	return 0;
+}
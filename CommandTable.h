@@ -0,0 +1,122 @@
+#ifndef __COMMANDTABLE_H__ // INCLUDE GUARD
+#define __COMMANDTABLE_H__
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <span>
+#include <algorithm>
+#include "Game.h"
+
+/*
+ * CommandTable is the table of everything the user can type as a
+ * command (including synonyms like chat for talk), and the Game method
+ * each one calls. The table and a perfect hash over its names are built
+ * at compile time, so finding a command is a hash and one compare, and
+ * calling it is a member function pointer call; nothing is set up when
+ * a Game is made. show_help lists the commands from it, in the order
+ * they're written here (alphabetical).
+ */
+
+// A command name and the Game method it calls
+struct Command{
+	std::string_view name;
+	void (Game::*handler)(std::span<const std::string_view> target);
+};
+
+// All commands, sorted by name. Multiple names refer to the same method to account
+// for synonyms/other similar commands the player may try typing.
+inline constexpr std::array<Command, 17> COMMAND_TABLE = {{
+	{"?", &Game::show_help},
+	{"buy", &Game::buy},
+	{"chat", &Game::talk},
+	{"give", &Game::give},
+	{"go", &Game::go},
+	{"greet", &Game::meet},
+	{"help", &Game::show_help},
+	{"inventory", &Game::show_items},
+	{"look", &Game::look},
+	{"meet", &Game::meet},
+	{"pickpocket", &Game::steal},
+	{"quit", &Game::quit},
+	{"rob", &Game::steal},
+	{"show_items", &Game::show_items},
+	{"steal", &Game::steal},
+	{"take", &Game::take},
+	{"talk", &Game::talk},
+}};
+
+// Keep the table sorted (show_help prints it in this order), with no repeated names
+static_assert(std::adjacent_find(COMMAND_TABLE.begin(), COMMAND_TABLE.end(), [](const Command& a, const Command& b){ return !(a.name < b.name); }) == COMMAND_TABLE.end(),
+	"COMMAND_TABLE must be sorted by name with no repeats");
+
+// The lookup uses a perfect hash: a seed is searched for at compile time so that
+// every name in COMMAND_TABLE lands in a different slot of COMMAND_SLOTS.
+// Finding a command is then one hash of the input, one slot read, and one string compare.
+inline constexpr std::size_t COMMAND_SLOT_COUNT = 64;
+
+// FNV-1a hash of a name, mixed with a seed
+constexpr std::uint32_t command_hash(std::string_view name, std::uint32_t seed){
+	std::uint32_t hash = 2166136261u ^ seed;
+	for (char c : name){
+		hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+	}
+	return hash;
+}
+
+// Check whether a seed puts every command in its own slot
+constexpr bool command_seed_works(std::uint32_t seed){
+	std::array<bool, COMMAND_SLOT_COUNT> used{};
+	for (const Command& command : COMMAND_TABLE){
+		std::size_t slot = command_hash(command.name, seed) % COMMAND_SLOT_COUNT;
+		if (used[slot]){
+			return false;
+		}
+		used[slot] = true;
+	}
+	return true;
+}
+
+// Find the first seed that works
+constexpr std::uint32_t find_command_seed(){
+	std::uint32_t seed = 0;
+	while (!command_seed_works(seed)){
+		seed++;
+	}
+	return seed;
+}
+
+inline constexpr std::uint32_t COMMAND_SEED = find_command_seed();
+
+// Slot -> index in COMMAND_TABLE, or -1 for an empty slot
+inline constexpr std::array<signed char, COMMAND_SLOT_COUNT> COMMAND_SLOTS = [](){
+	std::array<signed char, COMMAND_SLOT_COUNT> slots{};
+	for (signed char& slot : slots){
+		slot = -1;
+	}
+	for (std::size_t i = 0; i < COMMAND_TABLE.size(); i++){
+		slots[command_hash(COMMAND_TABLE[i].name, COMMAND_SEED) % COMMAND_SLOT_COUNT] = i;
+	}
+	return slots;
+}();
+
+/*
+ * find_command finds a command in COMMAND_TABLE by name.
+ *
+ * Args:
+ * The name the user typed.
+ *
+ * Returns:
+ * A pointer to the command, or nullptr if there is no command with that name.
+ */
+constexpr const Command* find_command(std::string_view name){
+	int index = COMMAND_SLOTS[command_hash(name, COMMAND_SEED) % COMMAND_SLOT_COUNT];
+	if (index < 0 || COMMAND_TABLE[index].name != name){
+		return nullptr;
+	}
+	return &COMMAND_TABLE[index];
+}
+
+static_assert(find_command("talk") == &COMMAND_TABLE[16] && find_command("Talk") == nullptr, "find_command is broken");
+
+#endif
@@ -0,0 +1,32 @@
+#include "CommandTokenizer.h"
+
+/*
+ * CommandTokenizer splits user input into words without
+ * copying them, and joins runs of words back together.
+ */
+
+// Split the line on every space into views of the line
+std::span<const std::string_view> CommandTokenizer::split(std::string_view line){
+	tokens.clear(); // Keeps the capacity, so this doesn't free anything
+	std::size_t start = 0;
+	while (true){
+		std::size_t space = line.find(' ', start);
+		if (space == std::string_view::npos){
+			tokens.push_back(line.substr(start));
+			break;
+		}
+		tokens.push_back(line.substr(start, space - start));
+		start = space + 1;
+	}
+	return tokens;
+}
+
+// Get the text from the start of the first word to the end of the last
+std::string_view CommandTokenizer::join(std::span<const std::string_view> words){
+	if (words.empty()){
+		return std::string_view();
+	}
+	const char* first = words.front().data();
+	const char* last = words.back().data() + words.back().size();
+	return std::string_view(first, last - first);
+}
@@ -0,0 +1,47 @@
+#ifndef __COMMANDTOKENIZER_H__ // INCLUDE GUARD
+#define __COMMANDTOKENIZER_H__
+
+#include <string_view>
+#include <vector>
+#include <span>
+
+/*
+ * Header file for CommandTokenizer.cpp
+ * CommandTokenizer splits a line of user input into words on spaces.
+ * The words are string_views into the line itself, and the vector
+ * holding them is reused from line to line, so once it has grown to
+ * the longest line seen, splitting a line doesn't allocate any memory.
+ * The line must stay alive (and unchanged) while the words are used.
+ */
+
+class CommandTokenizer{
+	private:
+		std::vector<std::string_view> tokens; // Words of the last line, reused between lines
+	public:
+		/*
+		 * split splits a line into words on every space. Like
+		 * boost::split, two spaces in a row give an empty word, so
+		 * joining the words back with spaces gives the original line.
+		 *
+		 * Args:
+		 * The line to split.
+		 *
+		 * Returns:
+		 * A span over the words, valid until the next call to split.
+		 */
+		std::span<const std::string_view> split(std::string_view line);
+		/*
+		 * join gets the text covered by a run of words from the same line,
+		 * including the spaces between them, without copying it.
+		 *
+		 * Args:
+		 * Words returned by split.
+		 *
+		 * Returns:
+		 * A string_view from the start of the first word to the end of
+		 * the last word, or an empty string_view if there are no words.
+		 */
+		static std::string_view join(std::span<const std::string_view> words);
+};
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef __COWARRAY_H__ // INCLUDE GUARD
+#define __COWARRAY_H__
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+/*
+ * CowArray is an array that is cheap to copy: copies share their
+ * elements until one of them changes, and then only the part that
+ * changed is copied (copy on write). A World's locations and items,
+ * and each game's WorldState, are kept in CowArrays, so copying a
+ * World, or starting or forking a Game, costs a few pointer copies
+ * instead of copying every location, and playing on costs in proportion
+ * to what the game changes, not the size of the world.
+ *
+ * The elements are kept in leaves of LEAF_SIZE elements, under a tree
+ * of branches with up to 32 children each (a persistent radix tree).
+ * Reading element i walks down from the root, a handful of steps even
+ * for millions of elements. Writing does the same, but first copies
+ * each node on the way that is shared with another array, so a write
+ * copies one leaf and a few branches the first time, and nothing after.
+ *
+ * Like std::vector, but:
+ *  - the non-const operator[] and back() are for writing, and unshare
+ *    the element's leaf; read through a const CowArray (or std::as_const)
+ *    so reading doesn't copy anything
+ *  - iteration is read only
+ *  - elements never move, so references to them stay valid while the
+ *    array grows, until it is copied and then written to
+ * Copies can be used from different threads, as long as each array
+ * is only used by one thread at a time. Once unshare has been called,
+ * threads can also write different elements of one array at the same
+ * time (ex. the rooms of a SharedWorld), since writes copy nothing then,
+ * as long as the array isn't copied or resized while they do.
+ */
+
+template <typename T, int LEAF_SIZE = 16>
+class CowArray{
+	private:
+		static_assert(LEAF_SIZE > 0 && (LEAF_SIZE & (LEAF_SIZE - 1)) == 0, "LEAF_SIZE must be a power of two");
+		static const int BRANCH_BITS = 5;
+		static const int BRANCH_SIZE = 1 << BRANCH_BITS;
+		struct Node{
+			std::vector<std::shared_ptr<Node>> children; // Branches only: up to BRANCH_SIZE subtrees
+			std::vector<T> values; // Leaves only: up to LEAF_SIZE elements, never reallocated
+			Node(){
+			}
+			// Copies keep the leaf's room reserved, so its elements still never move
+			Node(const Node& other) : children(other.children){
+				values.reserve(other.values.capacity());
+				values = other.values;
+			}
+		};
+		std::shared_ptr<Node> root; // nullptr until the first element is added
+		int levels; // Levels of branches above the leaves (0 while the root is a leaf)
+		int count; // Number of elements
+
+		// A new, empty node; leaves get room for all their elements up front
+		static std::shared_ptr<Node> make_node(bool leaf){
+			std::shared_ptr<Node> node = std::make_shared<Node>();
+			if (leaf){
+				node->values.reserve(LEAF_SIZE);
+			}
+			return node;
+		}
+		// Make sure this array is the only one holding a node, copying it if it's shared
+		static Node* own(std::shared_ptr<Node>& node){
+			if (node.use_count() != 1){
+				node = std::make_shared<Node>(*node);
+			}
+			return node.get();
+		}
+		// Own a node, and every node below it (level is the number of levels of branches under it)
+		static void own_all(std::shared_ptr<Node>& node, int level){
+			Node* owned = own(node);
+			if (level > 0){
+				for (std::shared_ptr<Node>& child : owned->children){
+					own_all(child, level - 1);
+				}
+			}
+		}
+		// Number of elements the tree can hold without another level
+		long long capacity() const{
+			return static_cast<long long>(LEAF_SIZE) << (BRANCH_BITS * levels);
+		}
+		// The leaf holding element i, for reading
+		const Node* leaf(int i) const{
+			const Node* node = root.get();
+			int leafIndex = i / LEAF_SIZE;
+			for (int shift = BRANCH_BITS * (levels - 1); shift >= 0; shift -= BRANCH_BITS){
+				node = node->children[(leafIndex >> shift) & (BRANCH_SIZE - 1)].get();
+			}
+			return node;
+		}
+		// The leaf holding element i, unshared along the way, for writing. With grow,
+		// leaves and branches missing at the end of the tree are made (to add element i = count)
+		Node* own_leaf(int i, bool grow){
+			Node* node = own(root);
+			int leafIndex = i / LEAF_SIZE;
+			for (int shift = BRANCH_BITS * (levels - 1); shift >= 0; shift -= BRANCH_BITS){
+				std::size_t child = (leafIndex >> shift) & (BRANCH_SIZE - 1);
+				if (grow && child == node->children.size()){
+					node->children.push_back(make_node(shift == 0));
+				}
+				node = own(node->children[child]);
+			}
+			return node;
+		}
+	public:
+		// Read only iterator, walking one leaf at a time
+		class const_iterator{
+			private:
+				const CowArray* array;
+				int index;
+				const T* leafValues; // The leaf holding index, or nullptr at the end
+			public:
+				const_iterator(const CowArray* array, int index) : array(array), index(index),
+					leafValues(index < array->count ? array->leaf(index)->values.data() : nullptr){
+				}
+				const T& operator*() const{
+					return leafValues[index % LEAF_SIZE];
+				}
+				const T* operator->() const{
+					return &leafValues[index % LEAF_SIZE];
+				}
+				const_iterator& operator++(){
+					index++;
+					if (index % LEAF_SIZE == 0){
+						leafValues = (index < array->count) ? array->leaf(index)->values.data() : nullptr;
+					}
+					return *this;
+				}
+				bool operator==(const const_iterator& other) const{
+					return index == other.index;
+				}
+				bool operator!=(const const_iterator& other) const{
+					return index != other.index;
+				}
+		};
+
+		// Constructor, makes an empty array
+		CowArray() : levels(0), count(0){
+		}
+		int size() const{
+			return count;
+		}
+		bool empty() const{
+			return count == 0;
+		}
+		// Read an element
+		const T& operator[](int i) const{
+			return leaf(i)->values[i % LEAF_SIZE];
+		}
+		// Write an element (copies its leaf first if it is shared)
+		T& operator[](int i){
+			return own_leaf(i, false)->values[i % LEAF_SIZE];
+		}
+		const T& back() const{
+			return (*this)[count - 1];
+		}
+		T& back(){
+			return (*this)[count - 1];
+		}
+		const_iterator begin() const{
+			return const_iterator(this, 0);
+		}
+		const_iterator end() const{
+			return const_iterator(this, count);
+		}
+		/*
+		 * emplace_back makes a new element in place at the end.
+		 *
+		 * Args:
+		 * The arguments for the element's constructor.
+		 *
+		 * Returns:
+		 * A reference to the new element.
+		 */
+		template <typename... Args>
+		T& emplace_back(Args&&... args){
+			if (!root){
+				root = make_node(true);
+			} else if (count == capacity()){
+				// The tree is full, so it gets a new root with the old one as its first child
+				std::shared_ptr<Node> top = make_node(false);
+				top->children.push_back(std::move(root));
+				root = std::move(top);
+				levels++;
+			}
+			T& value = own_leaf(count, true)->values.emplace_back(std::forward<Args>(args)...);
+			count++;
+			return value;
+		}
+		void push_back(const T& value){
+			emplace_back(value);
+		}
+		void push_back(T&& value){
+			emplace_back(std::move(value));
+		}
+		// Remove the last element
+		void pop_back(){
+			own_leaf(count - 1, false)->values.pop_back();
+			count--; // An emptied leaf stays in the tree, and is filled again by the next emplace_back
+		}
+		/*
+		 * resize removes elements from the end, or adds copies of a value.
+		 *
+		 * Args:
+		 * size, the new number of elements
+		 * value, the value of any elements added
+		 */
+		void resize(int size, const T& value = T()){
+			while (count > size){
+				pop_back();
+			}
+			while (count < size){
+				emplace_back(value);
+			}
+		}
+		// Copy every node this array shares with another, so writing any element copies nothing from then on
+		void unshare(){
+			if (root){
+				own_all(root, levels);
+			}
+		}
+		// Remove every element
+		void clear(){
+			root.reset();
+			levels = 0;
+			count = 0;
+		}
+};
+
+#endif
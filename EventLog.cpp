@@ -0,0 +1,284 @@
+#include "EventLog.h"
+#include "Snapshot.h"
+#include "Game.h"
+#include "SymbolTable.h"
+#include <fstream>
+#include <algorithm> // For std::upper_bound
+#include <cstring>
+#include <stdexcept>
+
+/*
+ * EventLog appends each event a game records as a type byte
+ * and its fields, and reads them back one at a time.
+ */
+
+// Layout of a log's header. Every field is 4 bytes, like a snapshot's (see Snapshot.cpp).
+static const char EVENTLOG_MAGIC[4] = {'G', 'V', 'Z', 'E'};
+
+struct EventLogHeader{
+	char magic[4];
+	uint32_t version;
+	uint32_t headerSize;
+	// Checked against the world the log is replayed in
+	uint32_t locationCount;
+	uint32_t npcCount;
+	uint32_t worldItemCount;
+	uint32_t shopItemCount;
+};
+
+// Fields of each type of event, by type (see the list in EventLog.h)
+static const int FIELD_COUNTS[] = {
+	-1, // Types start at 1
+	1, // START, then the snapshot's bytes
+	0, // TURN
+	3, // TAKE
+	3, // GIVE
+	2, // EAT
+	2, // GO
+	3, // TELEPORT
+	2, // BUY
+	3, // STEAL
+	3, // TALK
+	0 // END
+};
+
+static const char* TYPE_NAMES[] = {"", "start", "turn", "take", "give", "eat", "go", "teleport", "buy", "steal", "talk", "end"};
+
+int EventLog::field_count(std::uint8_t type){
+	return (type >= START && type <= END) ? FIELD_COUNTS[type] : -1;
+}
+
+const char* EventLog::type_name(Type type){
+	return (type >= START && type <= END) ? TYPE_NAMES[type] : "unknown";
+}
+
+// Names with their numbers, so a log can be read without the world's file open
+void EventLog::print(std::ostream& out, const Event& event, const WorldDefinition& world){
+	const SymbolTable& symbols = SymbolTable::global();
+	auto location = [&](int l) -> std::ostream&{
+		if (l < 0 || l >= world.location_count()){
+			return out << "? (location " << l << ")";
+		}
+		return out << symbols.name(world.locations[l].nameId) << " (location " << l << ")";
+	};
+	auto item = [&](ItemHandle i) -> std::ostream&{
+		if (i < 0 || i >= world.items.size()){
+			return out << "? (item " << i << ")";
+		}
+		return out << symbols.name(world.items.name_id(i)) << " (item " << i << ")";
+	};
+	// An NPC by its number in the world, found in its location from the location's first number
+	auto npc = [&](int n) -> std::ostream&{
+		if (n < 0 || n >= world.npc_count()){
+			return out << "? (NPC " << n << ")";
+		}
+		int l = std::upper_bound(world.firstNpcs.begin(), world.firstNpcs.end(), n) - world.firstNpcs.begin() - 1;
+		return out << symbols.name(world.locations[l].locationNPCs[n - world.firstNpcs[l]].nameId) << " (NPC " << n << ")";
+	};
+	const std::int32_t* fields = event.fields;
+	out << type_name(event.type);
+	switch (event.type){
+		case START:
+			out << " (snapshot of " << event.snapshot.size() << " bytes)";
+			break;
+		case TAKE:
+			out << " ";
+			item(fields[2]) << " from ";
+			location(fields[0]);
+			break;
+		case GIVE:
+			out << " ";
+			item(fields[2]) << " to ";
+			location(fields[0]);
+			break;
+		case EAT:
+			out << " ";
+			item(fields[1]) << " (the Elf ate it)";
+			break;
+		case GO:
+		case TELEPORT:
+			out << " from ";
+			location(fields[0]) << " to ";
+			location(fields[1]);
+			if (event.type == TELEPORT){
+				out << (fields[2] ? ", drawn at random" : ", caught stealing");
+			}
+			break;
+		case BUY:
+			out << " ";
+			item(fields[1]) << " (shop item " << fields[0] << ")";
+			break;
+		case STEAL:
+			out << " from ";
+			npc(fields[0]) << ", rolled " << fields[1] << ", got " << fields[2] << " coins";
+			break;
+		case TALK:
+			out << " to ";
+			if (fields[0] < 0 || fields[0] >= world.location_count() || fields[1] < 0 || fields[1] >= static_cast<int>(world.locations[fields[0]].locationNPCs.size())){
+				out << "? (NPC " << fields[1] << " of location " << fields[0] << ")";
+			} else {
+				npc(world.npc_number(fields[0], fields[1]));
+			}
+			out << ", message " << fields[2];
+			break;
+		default:
+			break;
+	}
+}
+
+void EventLog::write_header(const WorldDefinition& world, std::string& bytes){
+	EventLogHeader header{};
+	std::memcpy(header.magic, EVENTLOG_MAGIC, sizeof(EVENTLOG_MAGIC));
+	header.version = VERSION;
+	header.headerSize = sizeof(EventLogHeader);
+	header.locationCount = world.location_count();
+	header.npcCount = world.npc_count();
+	header.worldItemCount = world.shopStart;
+	header.shopItemCount = world.shopCount;
+	bytes.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+std::size_t EventLog::check_header(std::string_view bytes, const WorldDefinition& world){
+	if (bytes.size() < sizeof(EventLogHeader)){
+		throw std::invalid_argument("Event log is too small.");
+	}
+	EventLogHeader header;
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	if (std::memcmp(header.magic, EVENTLOG_MAGIC, sizeof(EVENTLOG_MAGIC)) != 0){
+		throw std::invalid_argument("Not an event log.");
+	}
+	if (header.version != VERSION || header.headerSize != sizeof(EventLogHeader)){
+		throw std::invalid_argument("Event log is version " + std::to_string(header.version) + ", expected " + std::to_string(VERSION) + ".");
+	}
+	if (header.locationCount != static_cast<uint32_t>(world.location_count()) || header.npcCount != static_cast<uint32_t>(world.npc_count())
+		|| header.worldItemCount != static_cast<uint32_t>(world.shopStart) || header.shopItemCount != static_cast<uint32_t>(world.shopCount)){
+		throw std::invalid_argument("Event log is of a different world.");
+	}
+	return sizeof(EventLogHeader);
+}
+
+EventLog::EventLog(const WorldDefinition& world){
+	write_header(world, bytes);
+}
+
+// The type byte, then the fields the type has (the rest of the arguments are left out)
+void EventLog::append(Type type, std::int32_t first, std::int32_t second, std::int32_t third){
+	std::int32_t fields[3] = {first, second, third};
+	bytes.push_back(static_cast<char>(type));
+	bytes.append(reinterpret_cast<const char*>(fields), FIELD_COUNTS[type] * sizeof(std::int32_t));
+}
+
+// The snapshot is saved straight onto the end of the log, after its size
+void EventLog::start(const Game& game){
+	std::string snapshot;
+	Snapshot::save(game, snapshot);
+	append(START, snapshot.size());
+	bytes += snapshot;
+}
+
+void EventLog::turn(){
+	append(TURN);
+}
+
+void EventLog::take(int location, int slot, ItemHandle item){
+	append(TAKE, location, slot, item);
+}
+
+void EventLog::give(int location, int slot, ItemHandle item){
+	append(GIVE, location, slot, item);
+}
+
+void EventLog::eat(int slot, ItemHandle item){
+	append(EAT, slot, item);
+}
+
+void EventLog::go(int from, int to){
+	append(GO, from, to);
+}
+
+void EventLog::teleport(int from, int to, bool drawn){
+	append(TELEPORT, from, to, drawn);
+}
+
+void EventLog::buy(int sold, ItemHandle item){
+	append(BUY, sold, item);
+}
+
+void EventLog::steal(int npc, int roll, int coins){
+	append(STEAL, npc, roll, coins);
+}
+
+void EventLog::talk(int location, int npc, int message){
+	append(TALK, location, npc, message);
+}
+
+void EventLog::end(){
+	append(END);
+}
+
+std::string_view EventLog::data() const{
+	return bytes;
+}
+
+// Write the log out in one go
+void EventLog::save_file(const std::string& path) const{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(bytes.data(), bytes.size());
+	if (!file){
+		throw std::invalid_argument("Could not write event log file: " + path);
+	}
+}
+
+// Read the whole file in one go
+std::string EventLog::load_file(const std::string& path){
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file){
+		throw std::invalid_argument("Could not open event log file: " + path);
+	}
+	std::string bytes(static_cast<std::size_t>(file.tellg()), '\0');
+	file.seekg(0);
+	file.read(bytes.data(), bytes.size());
+	if (!file){
+		throw std::invalid_argument("Could not read event log file: " + path);
+	}
+	return bytes;
+}
+
+EventLog::Reader::Reader(std::string_view bytes, const WorldDefinition& world) : bytes(bytes), next(check_header(bytes, world)){
+}
+
+// Read the type, then its fields (copied out, since they may not be 4 byte aligned), then a START's snapshot
+bool EventLog::Reader::read(Event& event){
+	if (next == bytes.size()){
+		return false;
+	}
+	int fields = field_count(bytes[next]);
+	if (fields < 0){
+		throw std::invalid_argument("Event log has an unknown event at byte " + std::to_string(next) + ".");
+	}
+	std::size_t size = 1 + fields * sizeof(std::int32_t);
+	if (bytes.size() - next < size){
+		throw std::invalid_argument("Event log is cut off in the middle of an event.");
+	}
+	event.type = static_cast<Type>(bytes[next]);
+	event.fields[0] = event.fields[1] = event.fields[2] = 0;
+	std::memcpy(event.fields, bytes.data() + next + 1, fields * sizeof(std::int32_t));
+	event.snapshot = std::string_view();
+	if (event.type == START){
+		if (event.fields[0] < 0 || bytes.size() - next - size < static_cast<std::size_t>(event.fields[0])){
+			throw std::invalid_argument("Event log is cut off in the middle of an event.");
+		}
+		event.snapshot = bytes.substr(next + size, event.fields[0]);
+		size += event.fields[0];
+	}
+	next += size;
+	return true;
+}
+
+std::size_t EventLog::Reader::position() const{
+	return next;
+}
+
+void EventLog::Reader::seek(std::size_t position){
+	next = position;
+}
@@ -0,0 +1,172 @@
+#ifndef __EVENTLOG_H__ // INCLUDE GUARD
+#define __EVENTLOG_H__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "WorldDefinition.h"
+#include "ItemStore.h"
+
+class Game;
+
+/*
+ * Header file for EventLog.cpp
+ * An EventLog is a record of everything that happened in a game, as it
+ * happened. A Game recording into a log (see Game::record_events) adds
+ * an event for every change its commands make: the items taken, given
+ * away, and eaten, the places gone to, teleports, purchases, steals, and
+ * conversations. Every number drawn from the game's random number generator
+ * (where a teleport went, how a steal went) is in its event too. The log
+ * is only ever added to, so it can be saved at any point (ex. when a bug
+ * shows up) and replayed by an EventReplayer into the game as it was at
+ * any turn (see EventReplayer.h).
+ *
+ * The log starts with a header that identifies the world, the same way as
+ * a snapshot's. Each event is a one byte type and a fixed number of 4 byte
+ * fields for that type (the most is 3, so an event is at most 13 bytes):
+ *   START     snapshot size, then the snapshot of the game when recording
+ *             started (see Snapshot.h), so a log can start at any point of
+ *             a game, and one log can hold many games one after another
+ *   TURN      (none), a line of input was run; the events after it are its changes
+ *   TAKE      location, slot in the location, item
+ *   GIVE      location, slot in the inventory, item
+ *   EAT       slot in the inventory, item (the Elf ate it)
+ *   GO        from, to; from is visited, and to is from if the player couldn't go
+ *   TELEPORT  from, to, 1 if to was drawn at random (0 for campus security)
+ *   BUY       shop item number, item
+ *   STEAL     NPC number, the roll drawn, coins stolen (0 if none)
+ *   TALK      location, NPC in the location, the message number it said
+ *   END       (none), the game ended without a win (quit, or struck by the Elf)
+ * Each field is written as the machine's own 4 byte int, the same as a
+ * snapshot's, so logs are read back on the same kind of machine.
+ */
+
+class EventLog{
+	public:
+		// Logs of other versions can't be read
+		static const std::uint32_t VERSION = 1;
+		// The kinds of events, as written in the log
+		enum Type : std::uint8_t{
+			START = 1,
+			TURN,
+			TAKE,
+			GIVE,
+			EAT,
+			GO,
+			TELEPORT,
+			BUY,
+			STEAL,
+			TALK,
+			END
+		};
+		// One event read back from a log
+		struct Event{
+			Type type;
+			std::int32_t fields[3]; // The type's fields, in the order listed above (the rest are 0)
+			std::string_view snapshot; // For START, the snapshot; it points into the log
+		};
+		// Reads a log's events one after another
+		class Reader{
+			private:
+				std::string_view bytes; // The whole log
+				std::size_t next; // Where the next event starts
+			public:
+				/*
+				 * Constructor, which checks the log's header against the
+				 * world it will be replayed in. Throws an invalid_argument
+				 * exception if the bytes aren't a log of the current version
+				 * for that world.
+				 *
+				 * Args:
+				 * bytes, the log; it must outlive the reader
+				 * world, the world the log was recorded in
+				 */
+				Reader(std::string_view bytes, const WorldDefinition& world);
+				/*
+				 * read reads the next event. Throws an invalid_argument
+				 * exception if the log is cut off in the middle of an event,
+				 * or has one of an unknown type.
+				 *
+				 * Args:
+				 * The event to read into.
+				 *
+				 * Returns:
+				 * False once there are no more events.
+				 */
+				bool read(Event& event);
+				// Where the next event starts, counted in bytes from the start of the log
+				std::size_t position() const;
+				// Go back (or on) to an event at the given position, ex. one from position()
+				void seek(std::size_t position);
+		};
+	private:
+		std::string bytes; // The header, then every event so far
+		// Write the header for a log of the given world into bytes
+		static void write_header(const WorldDefinition& world, std::string& bytes);
+		// Check a log's header against the world, returning where the first event starts
+		static std::size_t check_header(std::string_view bytes, const WorldDefinition& world);
+		// Add an event with its fields
+		void append(Type type, std::int32_t first = 0, std::int32_t second = 0, std::int32_t third = 0);
+	public:
+		/*
+		 * Constructor, for an empty log of games in the given world.
+		 *
+		 * Args:
+		 * The world the games are played in.
+		 */
+		EventLog(const WorldDefinition& world);
+		// The number of 4 byte fields an event of the given type has, or -1 if it's not a type
+		static int field_count(std::uint8_t type);
+		// The name of a type of event, ex. for printing a log
+		static const char* type_name(Type type);
+		/*
+		 * print writes an event as a line of text (without the newline),
+		 * naming the locations, items, and NPCs in it, ex. for reading
+		 * through a log. Numbers that aren't in the world print as "?".
+		 *
+		 * Args:
+		 * out, the stream to write to
+		 * event, the event (ex. from a Reader)
+		 * world, the world the log was recorded in
+		 */
+		static void print(std::ostream& out, const Event& event, const WorldDefinition& world);
+		// Record a game as it is now, which its later events start from (Game::record_events does this)
+		void start(const Game& game);
+		// Record that a line of input is about to run
+		void turn();
+		// Record one event each, with the fields listed above
+		void take(int location, int slot, ItemHandle item);
+		void give(int location, int slot, ItemHandle item);
+		void eat(int slot, ItemHandle item);
+		void go(int from, int to);
+		void teleport(int from, int to, bool drawn);
+		void buy(int sold, ItemHandle item);
+		void steal(int npc, int roll, int coins);
+		void talk(int location, int npc, int message);
+		void end();
+		// The whole log so far, valid until the next event is added
+		std::string_view data() const;
+		/*
+		 * save_file writes the log so far to a file in a single write.
+		 * Throws an invalid_argument exception if the file can't be written.
+		 *
+		 * Args:
+		 * The path of the file to write.
+		 */
+		void save_file(const std::string& path) const;
+		/*
+		 * load_file reads a whole log file, to replay or read (it isn't
+		 * checked until then). Throws an invalid_argument exception if
+		 * the file can't be read.
+		 *
+		 * Args:
+		 * The path of the log file.
+		 *
+		 * Returns:
+		 * The bytes of the log.
+		 */
+		static std::string load_file(const std::string& path);
+};
+
+#endif
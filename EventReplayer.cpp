@@ -0,0 +1,172 @@
+#include "EventReplayer.h"
+#include "Snapshot.h"
+#include <algorithm> // For std::max
+#include <utility>
+#include <stdexcept>
+
+/*
+ * EventReplayer applies a log's events to a game, checking each
+ * one, and seeks between turns from forked checkpoints.
+ */
+
+// Replay the whole log, forking a checkpoint at the end of every interval-th turn
+EventReplayer::EventReplayer(std::shared_ptr<const WorldDefinition> world, std::string log, int interval) : world(std::move(world)), log(std::move(log)),
+	game(this->world, 0, output.stream()), reader(this->log, *this->world), interval(std::max(1, interval)), currentTurn(0){
+	EventLog::Event event;
+	if (!reader.read(event) || event.type != EventLog::START){
+		throw std::invalid_argument("Event log doesn't start with a game.");
+	}
+	apply(event);
+	bool turnOpen = true; // Whether the turn the events are in hasn't ended yet (turn 0 ends at the first TURN)
+	while (true){
+		std::size_t position = reader.position();
+		bool more = reader.read(event);
+		// A turn ends at the next one, or at the next game, which starts before its first turn
+		if (turnOpen && (!more || event.type == EventLog::TURN || event.type == EventLog::START)){
+			if (turnEnds.size() % this->interval == 0){
+				checkpoints.push_back(game.fork(output.stream()));
+			}
+			turnEnds.push_back(position);
+			turnOpen = false;
+		}
+		if (!more){
+			break;
+		}
+		if (event.type == EventLog::TURN){
+			turnOpen = true;
+		} else {
+			apply(event);
+		}
+	}
+	currentTurn = turn_count();
+	// A game that started after the last turn, but never had a turn of its own, isn't at any turn, so go back to the last one
+	if (reader.position() != turnEnds.back()){
+		currentTurn = -1;
+		seek(turn_count());
+	}
+}
+
+void EventReplayer::check(bool ok, const EventLog::Event& event) const{
+	if (!ok){
+		throw std::invalid_argument("Event log doesn't match the game: the " + std::string(EventLog::type_name(event.type))
+			+ " event in turn " + std::to_string(turnEnds.size()) + " can't have happened.");
+	}
+}
+
+// The same changes the command made, from the fields of its event
+void EventReplayer::apply(const EventLog::Event& event){
+	const ItemStore& store = world->items;
+	WorldState& state = *game.state;
+	Inventory& inventory = game.inventory;
+	const std::int32_t* fields = event.fields;
+	// Whether go could have taken the player from one location to another (or left them where they were)
+	auto is_exit = [this](int from, int to){
+		const WorldGraph& graph = world->graph;
+		for (int e = graph.edges_begin(from); e < graph.edges_end(from) && from != to; e++){
+			if (graph.edge_target(e) == to){
+				return true;
+			}
+		}
+		return from == to;
+	};
+	// Whether the inventory has the item in the slot
+	auto carried = [&inventory](int slot, ItemHandle item){
+		return slot >= 0 && slot < inventory.size() && inventory.items()[slot] == item;
+	};
+	switch (event.type){
+		case EventLog::START:
+			Snapshot::restore(game, event.snapshot);
+			break;
+		case EventLog::TAKE:{
+			const std::vector<ItemHandle>& items = std::as_const(state).items(game.currentLocation);
+			check(fields[0] == game.currentLocation && fields[1] >= 0 && fields[1] < static_cast<int>(items.size()) && items[fields[1]] == fields[2], event);
+			state.take_item(fields[0], fields[1], store, inventory);
+			break;
+		}
+		case EventLog::GIVE:
+			check(fields[0] == game.currentLocation && carried(fields[1], fields[2]), event);
+			state.drop_item(fields[0], store, inventory, fields[1]);
+			break;
+		case EventLog::EAT:
+			check(game.currentLocation == world->elfLocation && carried(fields[0], fields[1]) && store.calories(fields[1]) > 0, event);
+			inventory.remove(store, state.slots, fields[0]);
+			game.winningCalories -= store.calories(fields[1]);
+			if (game.winningCalories <= 0){
+				game.inProgress = false;
+			}
+			break;
+		case EventLog::GO:
+			check(fields[0] == game.currentLocation && is_exit(fields[0], fields[1]), event);
+			state.set_visited(fields[0]);
+			game.currentLocation = fields[1];
+			break;
+		case EventLog::TELEPORT:{
+			check(fields[0] == game.currentLocation && (fields[2] == 0 || fields[2] == 1), event);
+			state.set_visited(fields[0]);
+			// Draw the location again, the same as the recorded game did
+			int to = (fields[2] == 1) ? game.random_location() : world->securityLocation;
+			check(to == fields[1], event);
+			game.currentLocation = to;
+			break;
+		}
+		case EventLog::BUY:
+			check(game.coins >= 25 && fields[1] == world->shopStart + fields[0] && state.sell_shop_item(world->shopCount) == fields[0], event);
+			game.coins -= 25;
+			inventory.add(store, state.slots, fields[1]);
+			break;
+		case EventLog::STEAL:{
+			check(fields[0] >= 0 && fields[0] < world->npc_count() && game.steal_roll() == fields[1], event);
+			int stolen = fields[2];
+			check(stolen == 0 || stolen == 5 || stolen == 10 || stolen == 15, event);
+			if (stolen > 0){
+				check(!std::as_const(state).npcs[fields[0]].robbed, event);
+				game.coins += stolen;
+				state.npcs[fields[0]].robbed = true;
+			}
+			break;
+		}
+		case EventLog::TALK:{
+			check(fields[0] == game.currentLocation && fields[1] >= 0 && fields[1] < static_cast<int>(world->locations[fields[0]].locationNPCs.size()), event);
+			int number = world->npc_number(fields[0], fields[1]);
+			check(std::as_const(state).npcs[number].messageNum == fields[2], event);
+			// Moves the NPC on to its next message, the same as talk does
+			world->locations[fields[0]].locationNPCs[fields[1]].getCurrentMessage(state.npcs[number].messageNum);
+			break;
+		}
+		case EventLog::END:
+			game.inProgress = false;
+			break;
+		default:
+			check(false, event);
+	}
+}
+
+int EventReplayer::turn_count() const{
+	return turnEnds.size() - 1;
+}
+
+int EventReplayer::turn() const{
+	return currentTurn;
+}
+
+// Go back to the checkpoint before the turn, unless the game is already between it and the turn, then apply the events up to the turn
+const Game& EventReplayer::seek(int turn){
+	if (turn < 0 || turn > turn_count()){
+		throw std::invalid_argument("Event log has no turn " + std::to_string(turn) + ".");
+	}
+	int checkpoint = turn / interval;
+	if (currentTurn < checkpoint * interval || currentTurn > turn){
+		game = checkpoints[checkpoint].fork(output.stream());
+		currentTurn = checkpoint * interval;
+		reader.seek(turnEnds[currentTurn]);
+	}
+	EventLog::Event event;
+	while (reader.position() < turnEnds[turn]){
+		reader.read(event);
+		if (event.type != EventLog::TURN){
+			apply(event);
+		}
+	}
+	currentTurn = turn;
+	return game;
+}
@@ -0,0 +1,90 @@
+#ifndef __EVENTREPLAYER_H__ // INCLUDE GUARD
+#define __EVENTREPLAYER_H__
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Game.h"
+#include "EventLog.h"
+#include "OutputSink.h"
+#include "WorldDefinition.h"
+
+/*
+ * Header file for EventReplayer.cpp
+ * An EventReplayer rebuilds a game from an EventLog (see EventLog.h),
+ * as it was at any turn of the log: turn 0 is the game when recording
+ * started, and turn n is the game after the first n lines of input.
+ *
+ * Replaying doesn't run commands again. Each event is applied to the
+ * game's state directly, ex. a TAKE moves the item's handle from the
+ * room into the inventory, so replaying costs a few operations per event
+ * and doesn't depend on how the commands were typed or on the command
+ * handlers still working the way they did. Every event is checked against
+ * the game as it's rebuilt (the item taken is in that slot of the player's
+ * room, the NPC said the message it was on, ...), and the game draws its
+ * random numbers again where the recorded game did, which must come out
+ * the same as the numbers in the log, so a log that doesn't match its
+ * world or the game it starts from is caught at the first event that's off.
+ * Since the generator is kept in step, a rebuilt game can be forked and
+ * played on from any turn, the same as the recorded one would have.
+ *
+ * The whole log is replayed once when the replayer is made, keeping a
+ * checkpoint every interval turns. A checkpoint is a fork of the game
+ * (see Game::fork), which shares the world's state with the others until
+ * they differ, so it only takes memory for what changed since the last.
+ * Seeking to a turn goes back to the checkpoint at or before it and applies
+ * the events from there, so it costs at most interval turns of events,
+ * however long the log is, and seeking forward from the turn the game is
+ * already at only applies the events in between.
+ */
+
+class EventReplayer{
+	private:
+		std::shared_ptr<const WorldDefinition> world;
+		std::string log; // The replayer's own copy of the log, which the reader points into
+		NullSink output; // Where the game writes, though applying events never prints anything
+		Game game; // The rebuilt game, at turn currentTurn
+		EventLog::Reader reader; // Reads the log, just after the events of currentTurn
+		int interval; // Turns between checkpoints
+		std::vector<std::size_t> turnEnds; // For each turn, where in the log its events end (the next TURN or START, or the end of the log)
+		std::vector<Game> checkpoints; // The game at turn 0, interval, 2 * interval, ...
+		int currentTurn; // The turn the game is at
+		// Throw an invalid_argument exception saying where the log stopped matching the game, unless ok
+		void check(bool ok, const EventLog::Event& event) const;
+		// Change the game the way an event says, after checking it matches
+		void apply(const EventLog::Event& event);
+	public:
+		/*
+		 * Constructor, which replays the whole log once to check it and
+		 * set up the checkpoints. Throws an invalid_argument exception if
+		 * the log isn't a log of the current version for the world, doesn't
+		 * start with a game, or has an event that doesn't match the game.
+		 *
+		 * Args:
+		 * world, the world the log was recorded in
+		 * log, the log (ex. from EventLog::load_file)
+		 * interval, the number of turns between checkpoints (more means less
+		 * memory, and slower seeking)
+		 */
+		EventReplayer(std::shared_ptr<const WorldDefinition> world, std::string log, int interval = 1000);
+		EventReplayer(const EventReplayer&) = delete;
+		EventReplayer& operator=(const EventReplayer&) = delete;
+		// The number of turns in the log; the last turn is the game when the log was saved
+		int turn_count() const;
+		// The turn the game is at now
+		int turn() const;
+		/*
+		 * seek rebuilds the game as it was at a turn. Throws an invalid_argument
+		 * exception if the log has no such turn.
+		 *
+		 * Args:
+		 * The turn, from 0 to turn_count().
+		 *
+		 * Returns:
+		 * The game at that turn, valid until the next seek. Fork it to play on from there.
+		 */
+		const Game& seek(int turn);
+};
+
+#endif
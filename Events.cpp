@@ -0,0 +1,126 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include "Game.h"
+#include "EventLog.h"
+#include "EventReplayer.h"
+#include "Snapshot.h"
+#include "WorldLoader.h"
+
+/*
+ * Event log tool for GVZork.
+ * Reads an event log recorded by replay --record (see EventLog.h),
+ * checks the whole of it by replaying it (see EventReplayer.h), and
+ * prints how many turns and events it has. It can print every event, to
+ * go through what happened in a long session, and rebuild the game at
+ * any turn, ex. the turn before a bug report's bug, then print where the
+ * player is and what they carry, or save a snapshot that replay --load
+ * picks up to play on from there.
+ *
+ * Usage:
+ * events <log> [--world <file>] [--print] [--turn N] [--save <file>] [--interval N]
+ *  --world <file>  the world the log was recorded in, a text or compiled world
+ *                  file (default the built-in world)
+ *  --print         print every event, one per line, under the turn it happened in
+ *  --turn N        rebuild the game at turn N (0 is the start), and print the
+ *                  player's room and items (default the last turn)
+ *  --save <file>   save a snapshot of the game at that turn (see Snapshot.h)
+ *  --interval N    turns between the replayer's checkpoints (default 1000)
+ */
+
+int main(int argc, char** argv){
+	std::string logPath;
+	std::string worldPath;
+	bool print = false;
+	int turn = -1;
+	std::string savePath;
+	int interval = 1000;
+	try {
+		for (int a = 1; a < argc; a++){
+			std::string arg = argv[a];
+			if (arg == "--print"){
+				print = true;
+				continue;
+			}
+			if (arg.rfind("--", 0) != 0){
+				if (!logPath.empty()){
+					throw std::invalid_argument("More than one log given");
+				}
+				logPath = arg;
+				continue;
+			}
+			if (a + 1 >= argc){
+				throw std::invalid_argument("Missing value for " + arg);
+			}
+			std::string value = argv[++a];
+			if (arg == "--world"){
+				worldPath = value;
+			} else if (arg == "--turn"){
+				turn = std::stoi(value);
+			} else if (arg == "--save"){
+				savePath = value;
+			} else if (arg == "--interval"){
+				interval = std::stoi(value);
+			} else {
+				throw std::invalid_argument("Unknown option " + arg);
+			}
+		}
+		if (logPath.empty()){
+			throw std::invalid_argument("No log given");
+		}
+	} catch (const std::exception& e){
+		std::cerr << e.what() << "\nUsage: " << argv[0] << " <log> [--world <file>] [--print] [--turn N] [--save <file>] [--interval N]" << std::endl;
+		return 2;
+	}
+
+	try {
+		std::shared_ptr<const WorldDefinition> world = std::make_shared<const WorldDefinition>(worldPath.empty() ? Game::create_world() : WorldLoader::load_world(worldPath));
+		std::string log = EventLog::load_file(logPath);
+
+		// Read through the events once to count them, printing them if asked
+		EventLog::Reader reader(log, *world);
+		EventLog::Event event;
+		unsigned long long eventCount = 0;
+		int turnCount = 0; // Turns started so far
+		while (reader.read(event)){
+			if (event.type == EventLog::TURN){
+				turnCount++;
+				if (print){
+					std::cout << "Turn " << turnCount << ":\n";
+				}
+				continue;
+			}
+			eventCount++;
+			if (print){
+				// A game's start is between turns, so it isn't listed under one
+				std::cout << (event.type == EventLog::START ? "" : "  ");
+				EventLog::print(std::cout, event, *world);
+				std::cout << "\n";
+			}
+		}
+
+		std::size_t bytes = log.size();
+		EventReplayer replayer(world, std::move(log), interval);
+		std::cout << "Turns: " << replayer.turn_count() << "\n"
+			<< "Events: " << eventCount << "\n"
+			<< "Bytes: " << bytes << "\n";
+		if (turn < 0){
+			turn = replayer.turn_count();
+		}
+		const Game& game = replayer.seek(turn);
+		// Run look and items on a fork, so printing doesn't change the rebuilt game
+		std::cout << "At turn " << turn << (game.is_in_progress() ? "" : " (the game is over)") << ":\n";
+		Game shown = game.fork(std::cout);
+		shown.run_command("look");
+		shown.run_command("inventory");
+		std::cout << std::flush;
+		if (!savePath.empty()){
+			Snapshot::save_file(game, savePath);
+		}
+	} catch (const std::invalid_argument& e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
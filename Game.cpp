@@ -1,20 +1,23 @@
 #include "Game.h"
+#include "SymbolTable.h"
+#include "CommandTable.h"
+#include "NameTrie.h"
+#include "EventLog.h"
 #include <iostream>
-#include <random> // To generate random number 
-#include <boost/algorithm/string.hpp> // For splitting user command string words
 #include <ctime> // For date and time stamp
-#include <functional>
-#include <iterator>
 #include <algorithm>
+#include <utility> // For std::as_const
+#include <optional>
+#include <mutex> // For std::lock_guard
+#include <stdexcept>
 
 /*
  * Game holds all the locations in the world,
- * the commands map, amount of calories
- * left to win, in progress status, and the player's
+ * the amount of calories left to win, in progress status, and the player's
  * current location, weight, inventory items,
  * and coins.
  * It includes methods to create the world (all the locations, 
- * NPCs, and Items), set up the commands, get a random location,
+ * NPCs, and Items), get a random location,
  * play which is the core game loop to take user input for commands,
  * and multiple command methods such as talk, go, etc., for the player
  * to interact with the game world,
@@ -23,14 +26,136 @@
  * Date: 10/6/2023
  */
 
-// Default Constructor
-Game::Game(){
-	// Set the commands map equal to the return call from setup_commands().
-	commands = Game::setup_commands();
-	// Call the create_world method. This method will also set the map/vectors for locations, items, and NPCs.
-	worldLocations = create_world();
+// Symbol IDs of the NPCs that the buy and steal commands treat specially
+static const int VENDING_MACHINE = SymbolTable::global().intern("Vending machine");
+static const int EMPLOYEE = SymbolTable::global().intern("Employee");
+static const int ELF = SymbolTable::global().intern("Elf");
+// Printed when a command's target isn't anywhere the command can reach
+static const char* INVALID_TARGET = "Invalid target. There's nothing by that name here; check the spelling.\n";
+// Most names a loose match can turn up before the text counts as too vague to check them all
+static const int MATCH_LIMIT = 32;
+
+/*
+ * resolve_name finds the name the player meant by a command's target,
+ * among the names present(id) accepts (ex. the NPCs in the room).
+ * The exact name is tried first. Then names matching it with any
+ * capitalization and spacing, then names it's a prefix of, then names
+ * one typo away (see NameTrie). The first of those that finds exactly
+ * one present name wins; if it finds more than one, the target is ambiguous.
+ * Matches are looked up in the whole world's trie, and then checked for
+ * being present. When more than MATCH_LIMIT names in the world match, the
+ * trie's list is cut short, so the names present (which names(ids) adds to
+ * a list) are checked against the text one by one instead.
+ *
+ * Returns:
+ * The symbol ID of the name, or -1 if nothing (or more than one thing) matched.
+ */
+template <typename Present, typename Names>
+static int resolve_name(std::string_view text, Present present, Names names){
+	const SymbolTable& symbols = SymbolTable::global();
+	int exact = symbols.lookup(text);
+	if (exact >= 0 && present(exact)){
+		return exact;
+	}
+	thread_local std::vector<int> candidates; // Reused, so a turn doesn't allocate
+	for (NameTrie::Match kind : {NameTrie::EXACT, NameTrie::PREFIX, NameTrie::TYPO}){
+		candidates.clear();
+		bool complete = symbols.matches(text, kind, candidates, MATCH_LIMIT);
+		int found = -1;
+		if (complete){
+			for (int id : candidates){
+				if (present(id)){
+					if (found >= 0){
+						return -1; // Ambiguous; don't guess
+					}
+					found = id;
+				}
+			}
+		} else {
+			candidates.clear();
+			names(candidates);
+			for (int id : candidates){
+				if (id != found && NameTrie::matches(symbols.name(id), text, kind)){
+					if (found >= 0){
+						return -1;
+					}
+					found = id;
+				}
+			}
+		}
+		if (found >= 0){
+			return found;
+		}
+	}
+	return -1;
+}
+
+// Find the NPC in the room the player meant, the way resolve_name finds a name
+int Game::resolve_npc(const Location& room, std::string_view text){
+	int nameId = resolve_name(text, [&room](int id){ return room.find_npc(id) >= 0; }, [&room](std::vector<int>& ids){
+		for (const NPC& npc : room.locationNPCs){
+			ids.push_back(npc.nameId);
+		}
+	});
+	return room.find_npc(nameId);
+}
+
+// The command names, for matching commands loosely. IDs are indexes into COMMAND_TABLE
+static const NameTrie& command_trie(){
+	static const NameTrie trie = [](){
+		NameTrie commands;
+		for (int c = 0; c < static_cast<int>(COMMAND_TABLE.size()); c++){
+			commands.insert(COMMAND_TABLE[c].name, c);
+		}
+		return commands;
+	}();
+	return trie;
+}
+
+// Find the command the player meant when it isn't spelled exactly, the same way as resolve_name.
+// Names that call the same method (ex. talk and chat) count as one.
+static const Command* resolve_command(std::string_view text){
+	thread_local std::vector<int> candidates;
+	for (NameTrie::Match kind : {NameTrie::EXACT, NameTrie::PREFIX, NameTrie::TYPO}){
+		candidates.clear();
+		if (!command_trie().find(text, kind, candidates, MATCH_LIMIT)){
+			return nullptr; // Too many commands match to say which
+		}
+		const Command* found = nullptr;
+		for (int c : candidates){
+			if (found != nullptr && found->handler != COMMAND_TABLE[c].handler){
+				return nullptr;
+			}
+			found = &COMMAND_TABLE[c];
+		}
+		if (found != nullptr){
+			return found;
+		}
+	}
+	return nullptr;
+}
+
+// Default Constructor, plays in the built-in world from create_world
+Game::Game() : Game(create_world()){
+}
+
+// Constructor to play in the given world, with a random seed
+Game::Game(World world) : Game(std::move(world), Random::random_seed()){
+}
+
+// Constructor to play in the given world, with the given seed
+Game::Game(World world, std::uint64_t seed) : Game(std::move(world), seed, std::cout){
+}
+
+// Constructor to play in the given world, with the given seed, writing output to the given stream
+Game::Game(World world, std::uint64_t seed, std::ostream& output) : Game(std::make_shared<const WorldDefinition>(std::move(world)), seed, output){
+}
+
+// Constructor to play in a shared world, with the given seed, writing output to the given stream
+Game::Game(std::shared_ptr<const WorldDefinition> world, std::uint64_t seed, std::ostream& output) : world(std::move(world)), out(&output), rng(seed), events(nullptr){
+	// Start from the world's starting state, shared until this game changes it
+	state = std::make_shared<WorldState>(this->world->start);
 	// Set default values for all other variables.
-	weight = 0;
 	winningCalories = 500;
 	inProgress = true;
 	coins = 0;
@@ -38,38 +163,67 @@ Game::Game(){
 	currentLocation = random_location();
 }
 
+// Constructor to play in a world with other players, with the given seed, writing output to the given stream
+Game::Game(std::shared_ptr<SharedWorld> world, std::uint64_t seed, std::ostream& output) : world(world->world), state(world->state),
+	shared(world), out(&output), rng(seed), events(nullptr){
+	winningCalories = 500;
+	inProgress = true;
+	coins = 0;
+	currentLocation = random_location();
+}
+
+// Copy the game, sharing the world's state until one of them changes it
+Game Game::fork(std::ostream& output) const{
+	if (shared){
+		throw std::invalid_argument("Games in a shared world can't be forked.");
+	}
+	Game copy(*this);
+	copy.state = std::make_shared<WorldState>(*state);
+	copy.out = &output;
+	copy.events = nullptr;
+	return copy;
+}
+
+// Start (or stop) recording, with the game as it is now as the start of its events
+void Game::record_events(EventLog* log){
+	if (shared && log != nullptr){
+		throw std::invalid_argument("Games in a shared world can't be recorded.");
+	}
+	events = log;
+	if (events != nullptr){
+		events->start(*this);
+	}
+}
+
 // Create_world method that sets all the locations, items, and npcs in the world.
-std::vector<Location> Game::create_world(){
-	// Declare all locations
-	Location woods("The Woods", "The woods behind the library. It's strangely quiet and serene...");
-	Location mackinacHall("Mackinac Hall", "A large building with many classrooms and offices. You've never seen it this empty before...");
-	Location podStore("The Pod Store", "A small store in Mackinac Hall with snacks and drinks. There are multiple places to sit.");
-	Location gym("The gym", "There's plenty of exercise equipment. It kind of smells, and it looks like some people forgot their drinks here.");
-	Location library("Mary Idema Pew Library", "There's plenty of areas to lounge around and study. There's a few students still studying...");
-	Location parkingLot("A parking lot", "There's a strange lack of cars today. Normally parking is MUCH worse...");
-	Location campusSecurity("Campus Security Building", "You would rather not spend too much time in here.");
-	Location kirkhoffCenter("Kirkhoff Center", "Theres multiple restaurants and places to sit and eat. There's plenty of half-eaten food left lying around...");
-	Location dormitory("One of the dormitories.", "Some students left their doors open. Maybe you can loot their dorms?");
+World Game::create_world(){
+	World world; // The world to fill in and return
+	// Build all locations in place, in index order (0 to 8). Locations never move
+	// once they're in the world's CowArray, so the references below stay valid.
+	Location& woods = world.locations.emplace_back("The Woods", "The woods behind the library. It's strangely quiet and serene...");
+	Location& mackinacHall = world.locations.emplace_back("Mackinac Hall", "A large building with many classrooms and offices. You've never seen it this empty before...");
+	Location& podStore = world.locations.emplace_back("The Pod Store", "A small store in Mackinac Hall with snacks and drinks. There are multiple places to sit.");
+	Location& gym = world.locations.emplace_back("The gym", "There's plenty of exercise equipment. It kind of smells, and it looks like some people forgot their drinks here.");
+	Location& library = world.locations.emplace_back("Mary Idema Pew Library", "There's plenty of areas to lounge around and study. There's a few students still studying...");
+	Location& parkingLot = world.locations.emplace_back("A parking lot", "There's a strange lack of cars today. Normally parking is MUCH worse...");
+	Location& campusSecurity = world.locations.emplace_back("Campus Security Building", "You would rather not spend too much time in here.");
+	Location& kirkhoffCenter = world.locations.emplace_back("Kirkhoff Center", "Theres multiple restaurants and places to sit and eat. There's plenty of half-eaten food left lying around...");
+	Location& dormitory = world.locations.emplace_back("One of the dormitories.", "Some students left their doors open. Maybe you can loot their dorms?");
 	//////////////////// Location 1 - Woods ///////////////////////
 	// Create items
-	Item leaves("Leaves", "A mix of green and brown leaves. Could an elf eat this?", 0, 3.5f);
-	Item sticks("Sticks", "Just some sticks... You have no use for them.", 0, 5.0f);
-	Item acorns("Acorns", "Some fallens acorns. Are they edible like this? You can't recall.", 0, 4.0f);
-	Item berries("Berries", "Some red berries on a bush. Let's hope they aren't poisonous...", 35, 2.5f);
 	// Add items to location
-	woods.add_item(leaves);
-	woods.add_item(sticks);
-	woods.add_item(acorns);
-	woods.add_item(berries);
+	woods.emplace_item(world.items, "Leaves", "A mix of green and brown leaves. Could an elf eat this?", 0, 3.5f);
+	woods.emplace_item(world.items, "Sticks", "Just some sticks... You have no use for them.", 0, 5.0f);
+	woods.emplace_item(world.items, "Acorns", "Some fallens acorns. Are they edible like this? You can't recall.", 0, 4.0f);
+	woods.emplace_item(world.items, "Berries", "Some red berries on a bush. Let's hope they aren't poisonous...", 35, 2.5f);
 	// Create NPCs
-	NPC Elf("Elf", "A strange and magical looking being. You can tell they are powerful. Perhaps they can help save the campus?");
-	Elf.addMessage("Who am I? You don't know me? Well, I'm just the most powerful elf in Allendale...");
-	Elf.addMessage("Your campus is in trouble? And you want my help? Sorry, I'm too hungry right now. I have no energy to do anything.");
-	Elf.addMessage("You're that desperate? Bring me food and I might consider helping. I'm famished.");
-	Elf.addMessage("How much food? I usually eat around 500 calories. That would do.");
-	Elf.addMessage("Their stomach growls loudly. They look embarrased.");
 	// Add NPC to location
-	woods.add_npc(Elf);
+	woods.emplace_npc("Elf", "A strange and magical looking being. You can tell they are powerful. Perhaps they can help save the campus?")
+		.addMessage("Who am I? You don't know me? Well, I'm just the most powerful elf in Allendale...")
+		.addMessage("Your campus is in trouble? And you want my help? Sorry, I'm too hungry right now. I have no energy to do anything.")
+		.addMessage("You're that desperate? Bring me food and I might consider helping. I'm famished.")
+		.addMessage("How much food? I usually eat around 500 calories. That would do.")
+		.addMessage("Their stomach growls loudly. They look embarrased.");
 	///////////////// Location 2 - Mackinac Hall ////////////////////////
 	// Create items (Don't add them to the location because they must be obtained
 	// through purchase from the vending machine).
@@ -77,532 +231,546 @@ std::vector<Location> Game::create_world(){
 	Item smallCandy("Candy", "A chocolate bar. You're tempted to eat it.", 25, 2.0f);
 	Item energyDrink("Energy drink", "An essential item for college students. Its packed full of caffeine. Hopefully the Elf doesn't have heart issues...", 10, 1.5f);
 	// Create NPCs
-	NPC Professor("Professor", "You haven't taken any of their classes.");
-	Professor.addMessage("Where are all the students at? No one showed up for my class...");
-	Professor.addMessage("What was I teaching? Well, I was giving a lecture on... (he rambles on for 20 minutes).");
-	Professor.addMessage("Interesting stuff, huh? Would you like to hear more?... No? Okay.");
-	NPC vendingMachine("Vending machine", "It's a vending machine with plenty of snacks and drinks. If you had money you could buy some.");
-	vendingMachine.addMessage("The vending machine sits there silently.");
-	vendingMachine.addMessage("It doesn't talk. Maybe you should give it money *cough* 25 coins *cough* and buy something?");
 	// Add NPCs to location
-	mackinacHall.add_npc(Professor);
-	mackinacHall.add_npc(vendingMachine);
+	mackinacHall.emplace_npc("Professor", "You haven't taken any of their classes.")
+		.addMessage("Where are all the students at? No one showed up for my class...")
+		.addMessage("What was I teaching? Well, I was giving a lecture on... (he rambles on for 20 minutes).")
+		.addMessage("Interesting stuff, huh? Would you like to hear more?... No? Okay.");
+	mackinacHall.emplace_npc("Vending machine", "It's a vending machine with plenty of snacks and drinks. If you had money you could buy some.")
+		.addMessage("The vending machine sits there silently.")
+		.addMessage("It doesn't talk. Maybe you should give it money *cough* 25 coins *cough* and buy something?");
 	/////////////// Location 3 - Pod Store ////////////////////////
 	// Create items (Again, not adding some to the location since they must be bought through employee)
 	Item sandwich("Sandwich", "A turkey, cheese, lettuce, and mayo sandwich. It doesn't look bad.", 50, 5);
-	Item water("Water", "A water bottle. It has 0 calories, but maybe the Elf is thirsty?", 0, 4.0f);
 	Item candy("Large candy bar", "A large caramel chocolate candy bar. Yum!", 45, 4.0f);
 	Item chips("Large bag of chips", "A large bag of spicy chips. They taste good, but beware of heartburn!", 45, 5.0f);
 	// Add freely available item to location
-	podStore.add_item(water);
+	podStore.emplace_item(world.items, "Water", "A water bottle. It has 0 calories, but maybe the Elf is thirsty?", 0, 4.0f);
 	// Create NPCs
-	NPC Employee("Employee", "It's a store employee. You could purchase some items through them.");
-	Employee.addMessage("I shouldn't have to be working right now...");
-	Employee.addMessage("Want to buy something? For 25 coins I'll give you something tasty.");
-	Employee.addMessage("Why am I using coins instead of normal cash? This is an adventure game... don't question it.");
-	NPC Student1("Random Student", "It's a random student eating a sandwich. They look carefree.");
-	Student1.addMessage("Just aced my exams. Too easy!");
 	// Add NPCs to location
-	podStore.add_npc(Employee);
-	podStore.add_npc(Student1);
+	podStore.emplace_npc("Employee", "It's a store employee. You could purchase some items through them.")
+		.addMessage("I shouldn't have to be working right now...")
+		.addMessage("Want to buy something? For 25 coins I'll give you something tasty.")
+		.addMessage("Why am I using coins instead of normal cash? This is an adventure game... don't question it.");
+	podStore.emplace_npc("Random Student", "It's a random student eating a sandwich. They look carefree.")
+		.addMessage("Just aced my exams. Too easy!");
 	////////////////// Location 4 - Gym //////////////////////
 	// Create items
-	Item proteinShake("Protein shake", "It doesn't look very appealing... How long has it been left here?", 50, 5.0f);
-	Item gatorade("Gatorade", "An open gatorade. Someone drank out of this... yuck.", 25, 3.0f);
-	Item weights("A single weight", "Do you really need this? It would likely just weigh you down.", 0, 15.0f);
 	// Add items to location
-	gym.add_item(proteinShake);
-	gym.add_item(gatorade);
-	gym.add_item(weights);
+	gym.emplace_item(world.items, "Protein shake", "It doesn't look very appealing... How long has it been left here?", 50, 5.0f);
+	gym.emplace_item(world.items, "Gatorade", "An open gatorade. Someone drank out of this... yuck.", 25, 3.0f);
+	gym.emplace_item(world.items, "A single weight", "Do you really need this? It would likely just weigh you down.", 0, 15.0f);
 	// Create NPCs
-	NPC rat("Rat", "It's a large rat!!!");
-	rat.addMessage("*The rat squeaks at you.*");
-	rat.addMessage("(Need some cash? Try using *steal* on an NPC. Just don't get caught!)... *Wait, did the rat just speak?*");
-	NPC athlete("Athlete", "Some athlete exercising. Go Lakers!");
-	athlete.addMessage("I'm busy making gains right now.");
 	// Add NPCs to location
-	gym.add_npc(rat);
-	gym.add_npc(athlete);
+	gym.emplace_npc("Rat", "It's a large rat!!!")
+		.addMessage("*The rat squeaks at you.*")
+		.addMessage("(Need some cash? Try using *steal* on an NPC. Just don't get caught!)... *Wait, did the rat just speak?*");
+	gym.emplace_npc("Athlete", "Some athlete exercising. Go Lakers!")
+		.addMessage("I'm busy making gains right now.");
 	/////////////// Location 5 - Library ////////////////////////
 	// Create items
-	Item book("Book", "A mystery novel. Seems interesting!", 0, 5.0f);
-	Item notebook("Notebook", "A used notebook. Looks like it was used for a math course.", 0, 4.0f);
-	Item laptop("Laptop", "Someone left their laptop here! You should probably leave it alone.", 0, 8.0f);
-	Item coffee("Coffee", "An essential drink for college students. You've drank it a lot before exams.", 35, 3.0f);
 	// Add items to location
-	library.add_item(book);
-	library.add_item(notebook);
-	library.add_item(laptop);
-	library.add_item(coffee);
+	library.emplace_item(world.items, "Book", "A mystery novel. Seems interesting!", 0, 5.0f);
+	library.emplace_item(world.items, "Notebook", "A used notebook. Looks like it was used for a math course.", 0, 4.0f);
+	library.emplace_item(world.items, "Laptop", "Someone left their laptop here! You should probably leave it alone.", 0, 8.0f);
+	library.emplace_item(world.items, "Coffee", "An essential drink for college students. You've drank it a lot before exams.", 35, 3.0f);
 	// Create NPCs
-	NPC librarian("Librarian", "You could ask them for help finding things.");
-	librarian.addMessage("Hi, can I help you?");
-	librarian.addMessage("You're on a quest to save the campus and need to collect food? Well, food isn't allowed in here. Try Kirkhoff Hall, you are bound to find food there.");
-	librarian.addMessage("If you have money, maybe you can buy food from stores and vending machines too.");
-	NPC sadStudent("A sad student", "Looks like they may have been crying. Maybe they flunked an exam?");
-	sadStudent.addMessage("MY LIFE IS OVER! I just failed two exams and missed a project deadline.");
-	sadStudent.addMessage("Thanks, but I'm okay... I probably should've studied.");
-	NPC stressedStudent("A stressed student", "They sit in front of a laptop, three open notebooks, and two energy drinks. They must be cramming for an exam. Good luck!");
-	stressedStudent.addMessage("Shhhh! I'm trying to study!");
-	stressedStudent.addMessage("This is my third energy drink today. I think I'm gonna puke. But I've never been more focused.");
-	stressedStudent.addMessage("I'm so gonna fail.. - no, wait, I'll just pull an allnighter and learn it all.");
 	// Add NPCs to location
-	library.add_npc(librarian);
-	library.add_npc(sadStudent);
-	library.add_npc(stressedStudent);
+	library.emplace_npc("Librarian", "You could ask them for help finding things.")
+		.addMessage("Hi, can I help you?")
+		.addMessage("You're on a quest to save the campus and need to collect food? Well, food isn't allowed in here. Try Kirkhoff Hall, you are bound to find food there.")
+		.addMessage("If you have money, maybe you can buy food from stores and vending machines too.");
+	library.emplace_npc("A sad student", "Looks like they may have been crying. Maybe they flunked an exam?")
+		.addMessage("MY LIFE IS OVER! I just failed two exams and missed a project deadline.")
+		.addMessage("Thanks, but I'm okay... I probably should've studied.");
+	library.emplace_npc("A stressed student", "They sit in front of a laptop, three open notebooks, and two energy drinks. They must be cramming for an exam. Good luck!")
+		.addMessage("Shhhh! I'm trying to study!")
+		.addMessage("This is my third energy drink today. I think I'm gonna puke. But I've never been more focused.")
+		.addMessage("I'm so gonna fail.. - no, wait, I'll just pull an allnighter and learn it all.");
 	/////////////// Location 6 - Parking Lot ////////////////////
 	// Create items
-	Item carKeys("Car keys", "Someone must've dropped them. That sucks.", 0, 2.0f);
-	Item wallet("Wallet", "It was dropped near the car keys. That's some serious bad luck!", 0, 3.0f);
-	Item granolaBar("Granola bar", "A crushed granola bar lying on the ground. You wouldn't eat it, but the Elf doesn't need to know where it came from.", 35, 3.0f);
 	// Add items to location
-	parkingLot.add_item(carKeys);
-	parkingLot.add_item(wallet);
-	parkingLot.add_item(granolaBar);
+	parkingLot.emplace_item(world.items, "Car keys", "Someone must've dropped them. That sucks.", 0, 2.0f);
+	parkingLot.emplace_item(world.items, "Wallet", "It was dropped near the car keys. That's some serious bad luck!", 0, 3.0f);
+	parkingLot.emplace_item(world.items, "Granola bar", "A crushed granola bar lying on the ground. You wouldn't eat it, but the Elf doesn't need to know where it came from.", 35, 3.0f);
 	// Create and add NPCs to location
-	NPC squirrel("Squirrel", "Aw, how cute! A friendly looking brown squirrel. It's eating something.");
-	squirrel.addMessage("*The squirrel stands up intimidatingly as if telling you to back up.*");
-	NPC badDriver("Driver", "It's a student driving. Seems like they are struggling to park.");
-	badDriver.addMessage("WATCH OUT! I'M DRIVING HERE!");
-	badDriver.addMessage("This is good enough, right?");
-	badDriver.addMessage("*The driver hits the car next to them with their door... They ignore it.*");
-	parkingLot.add_npc(squirrel);
-	parkingLot.add_npc(badDriver);
+	parkingLot.emplace_npc("Squirrel", "Aw, how cute! A friendly looking brown squirrel. It's eating something.")
+		.addMessage("*The squirrel stands up intimidatingly as if telling you to back up.*");
+	parkingLot.emplace_npc("Driver", "It's a student driving. Seems like they are struggling to park.")
+		.addMessage("WATCH OUT! I'M DRIVING HERE!")
+		.addMessage("This is good enough, right?")
+		.addMessage("*The driver hits the car next to them with their door... They ignore it.*");
 	/////////////// Location 7 - Campus Security ////////////////////////
 	// Create items
-	Item donuts("Box of donuts", "Oooh, a box of chocolate and powdered donuts. That's sort of cliche...", 50, 10.0f);
-	campusSecurity.add_item(donuts);
+	campusSecurity.emplace_item(world.items, "Box of donuts", "Oooh, a box of chocolate and powdered donuts. That's sort of cliche...", 50, 10.0f);
 	// Create and add NPCs and dialogue
-	NPC securityGuard("Security guard", "A security guard. He looks stern.");
-	securityGuard.addMessage("Don't do anything illegal. I'm watching you.");
-	securityGuard.addMessage("You DEFINITELY shouldn't try using *steal* on someone. That would get you in real trouble.");
-	NPC angryStudent("Angry student", "An angry student. Looks like they got in trouble.");
-	angryStudent.addMessage("This is so unfair!");
-	angryStudent.addMessage("I did nothing wrong. I'm calling my lawyer.");
-	campusSecurity.add_npc(securityGuard);
-	campusSecurity.add_npc(angryStudent);
+	campusSecurity.emplace_npc("Security guard", "A security guard. He looks stern.")
+		.addMessage("Don't do anything illegal. I'm watching you.")
+		.addMessage("You DEFINITELY shouldn't try using *steal* on someone. That would get you in real trouble.");
+	campusSecurity.emplace_npc("Angry student", "An angry student. Looks like they got in trouble.")
+		.addMessage("This is so unfair!")
+		.addMessage("I did nothing wrong. I'm calling my lawyer.");
 	/////////////// Location 8 - Kirkhoff Center ///////////////////////
 	// Create and add items
-	Item subwaySub("Subway sub", "A footlong oven-roasted turkey sub from subway, yum!", 60, 5.0f);
-	Item chickenBowl("Panda Express chicken and rice bowl", "A partly-eaten bowl of chicken and rice from Panda Express. It still looks appetizing.", 60, 5.0f);
-	Item mysteryFood("Dining hall mystery food", "You can't tell what this is... it doesn't smell the best.", 0, 4.0f);
-	Item napkins("Napkins", "Some napkins. Nothing special.", 0, 2.0f);
-	kirkhoffCenter.add_item(subwaySub);
-	kirkhoffCenter.add_item(chickenBowl);
-	kirkhoffCenter.add_item(mysteryFood);
-	kirkhoffCenter.add_item(napkins);
+	kirkhoffCenter.emplace_item(world.items, "Subway sub", "A footlong oven-roasted turkey sub from subway, yum!", 60, 5.0f);
+	kirkhoffCenter.emplace_item(world.items, "Panda Express chicken and rice bowl", "A partly-eaten bowl of chicken and rice from Panda Express. It still looks appetizing.", 60, 5.0f);
+	kirkhoffCenter.emplace_item(world.items, "Dining hall mystery food", "You can't tell what this is... it doesn't smell the best.", 0, 4.0f);
+	kirkhoffCenter.emplace_item(world.items, "Napkins", "Some napkins. Nothing special.", 0, 2.0f);
 	// Create and add NPC
-	NPC janitor("Janitor", "They're cleaning up after the mess students left.");
-	janitor.addMessage("*whistling*");
-	kirkhoffCenter.add_npc(janitor);
+	kirkhoffCenter.emplace_npc("Janitor", "They're cleaning up after the mess students left.")
+		.addMessage("*whistling*");
 	////////////// Location 9 - Dormitory //////////////////////////
 	// Create and add items
-	Item chickenStrips("Half-eaten burnt chicken strips", "A popular food for college students. Looks like they air-fried it for too long.", 35, 3.0f);
-	Item cheetos("Flaming Hot Cheetos", "A bag of flaming hot cheetos. It's open and they smell stale.", 40, 3.0f);
-	dormitory.add_item(chickenStrips);
-	dormitory.add_item(cheetos);
+	dormitory.emplace_item(world.items, "Half-eaten burnt chicken strips", "A popular food for college students. Looks like they air-fried it for too long.", 35, 3.0f);
+	dormitory.emplace_item(world.items, "Flaming Hot Cheetos", "A bag of flaming hot cheetos. It's open and they smell stale.", 40, 3.0f);
 	//////////////// Shop Items /////////////////////////
 	// Some items held in a vector that you can buy using the added buy command
-	Item soda("Soda", "Packed with sugar... bad for your teeth... but so good!", 25, 3.0f);
-	Item goldenApple("Golden apple", "A real golden apple?! But you bought it for so cheap!", 100, 5.0f);
-	Item steak("Steak", "They sell steak here? It does look good though...", 50, 4.0f);
-	Item bread("Bread", "A small packaged bread roll.", 35, 3.0f);
-	Item MRE("MRE", "A precooked and prepackaged meal. This would be good in an apocalypse.", 75, 6.0f);
-	shopItems.push_back(soda);
-	shopItems.push_back(goldenApple);
-	shopItems.push_back(steak);
-	shopItems.push_back(bread);
-	shopItems.push_back(MRE);
-	///////////////////// Add Locations to World //////////////////////////////
-	std::vector<Location> allLocations; // Vector to add the locations to
-	// Add the locations
-	allLocations.push_back(woods); // 0
-	allLocations.push_back(mackinacHall); // 1
-	allLocations.push_back(podStore); // 2
-	allLocations.push_back(gym); // 3
-	allLocations.push_back(library); // 4
-	allLocations.push_back(parkingLot); // 5
-	allLocations.push_back(campusSecurity); // 6
-	allLocations.push_back(kirkhoffCenter); // 7
-	allLocations.push_back(dormitory); // 8
-	// Add locations neighbors
-	// Adding them this way fixed errors from adding the locations in other ways,
-	// ex. from calling add_location
-	allLocations[0].neighborsMap.insert_or_assign("West", allLocations[4]);
-	allLocations[1].neighborsMap.insert_or_assign("West", allLocations[6]);
-	allLocations[1].neighborsMap.insert_or_assign("North", allLocations[2]);
-	allLocations[1].neighborsMap.insert_or_assign("South", allLocations[3]);
-	allLocations[2].neighborsMap.insert_or_assign("North", allLocations[8]);
-	allLocations[2].neighborsMap.insert_or_assign("South", allLocations[1]);
-	allLocations[3].neighborsMap.insert_or_assign("North", allLocations[1]);
-	allLocations[3].neighborsMap.insert_or_assign("West", allLocations[5]);
-	allLocations[4].neighborsMap.insert_or_assign("West", allLocations[7]);
-	allLocations[4].neighborsMap.insert_or_assign("East", allLocations[0]);
-	allLocations[4].neighborsMap.insert_or_assign("South", allLocations[6]);
-	allLocations[5].neighborsMap.insert_or_assign("North", allLocations[6]);
-	allLocations[5].neighborsMap.insert_or_assign("East", allLocations[3]);
-	allLocations[6].neighborsMap.insert_or_assign("East", allLocations[1]);
-	allLocations[6].neighborsMap.insert_or_assign("South", allLocations[5]);
-	allLocations[6].neighborsMap.insert_or_assign("North", allLocations[4]);
-	allLocations[7].neighborsMap.insert_or_assign("East", allLocations[4]);
-	allLocations[8].neighborsMap.insert_or_assign("South", allLocations[2]);
-
-	return allLocations;
-}
-
-// Creates a new map. Keys = strings such as talk, give, go, etc.
-// Values of the map = names of functions to be called for each of those commands.
-std::map<std::string, std::function<void(std::vector<std::string> target)> > Game::setup_commands(){
-	// Add the function aliases to the map with the text input to refer to them
-	// Multiple keys refer to the same function to account for synonyms/other similar commands the player
-	// may try typing.
-	// Used ChatGPT to help figure out how to set the functions.
-	commands["help"] = [this](std::vector<std::string> target) { this->show_help(target); };
-	commands["?"] = [this](std::vector<std::string> target) { this->show_help(target); };
-	commands["talk"] = [this](std::vector<std::string> target) { this->talk(target); };
-	commands["chat"] = [this](std::vector<std::string> target) { this->talk(target); };
-	commands["meet"] = [this](std::vector<std::string> target) { this->meet(target); };
-	commands["greet"] = [this](std::vector<std::string> target) { this->meet(target); };
-	commands["take"] = [this](std::vector<std::string> target) { this->take(target); };
-	commands["give"] = [this](std::vector<std::string> target) { this->give(target); };
-	commands["go"] = [this](std::vector<std::string> target) { this->go(target); };
-	commands["show_items"] = [this](std::vector<std::string> target) { this->show_items(target); };
-	commands["inventory"] = [this](std::vector<std::string> target) { this->show_items(target); };
-	commands["look"] = [this](std::vector<std::string> target) { this->look(target); };
-	commands["quit"] = [this](std::vector<std::string> target) { this->quit(target); };
-	commands["buy"] = [this](std::vector<std::string> target) { this->buy(target); };
-	commands["steal"] = [this](std::vector<std::string> target) { this->steal(target); };
-	commands["rob"] = [this](std::vector<std::string> target) { this->steal(target); };
-	commands["pickpocket"] = [this](std::vector<std::string> target) { this->steal(target); };
-
-	return commands;
-}
-
- // Generate a random number within worldLocations vector size,
+	world.shopItems.emplace_back("Soda", "Packed with sugar... bad for your teeth... but so good!", 25, 3.0f);
+	world.shopItems.emplace_back("Golden apple", "A real golden apple?! But you bought it for so cheap!", 100, 5.0f);
+	world.shopItems.emplace_back("Steak", "They sell steak here? It does look good though...", 50, 4.0f);
+	world.shopItems.emplace_back("Bread", "A small packaged bread roll.", 35, 3.0f);
+	world.shopItems.emplace_back("MRE", "A precooked and prepackaged meal. This would be good in an apocalypse.", 75, 6.0f);
+	// Add locations neighbors, by index in world.locations
+	world.graph.add_edge(0, "West", 4);
+	world.graph.add_edge(1, "West", 6);
+	world.graph.add_edge(1, "North", 2);
+	world.graph.add_edge(1, "South", 3);
+	world.graph.add_edge(2, "North", 8);
+	world.graph.add_edge(2, "South", 1);
+	world.graph.add_edge(3, "North", 1);
+	world.graph.add_edge(3, "West", 5);
+	world.graph.add_edge(4, "West", 7);
+	world.graph.add_edge(4, "East", 0);
+	world.graph.add_edge(4, "South", 6);
+	world.graph.add_edge(5, "North", 6);
+	world.graph.add_edge(5, "East", 3);
+	world.graph.add_edge(6, "East", 1);
+	world.graph.add_edge(6, "South", 5);
+	world.graph.add_edge(6, "North", 4);
+	world.graph.add_edge(7, "East", 4);
+	world.graph.add_edge(8, "South", 2);
+	world.graph.build(world.locations.size());
+	// The Elf is in the woods, and getting caught stealing takes you to campus security
+	world.elfLocation = 0;
+	world.securityLocation = 6;
+
+	return world;
+}
+
+ // Generate a random number within the number of locations in the world,
  // which can then be used as an index to select a random world location
 int Game::random_location(){
-	// Used AI (chatGPT) for the following lines of code to generate a random number
-	std::random_device rd;  // Seed engine with a random value
-	std::mt19937 gen(rd()); // Mersenne Twister engine
-	// Select random number within the beginning and end of worldLocations vector
-	std::uniform_int_distribution<int> dist(0, (worldLocations.size() - 1));
-	int randomAccess = dist(gen);
-	return randomAccess;
+	// Select random number within the number of locations in the world
+	return rng.below(world->location_count());
+}
+
+// Generate a random number from 0 to 9 for deciding how stealing goes
+int Game::steal_roll(){
+	return rng.below(10);
+}
+
+// Print the message describing the game
+void Game::welcome(){
+	*out << "Welcome to GVZork!\nIn this story-driven, text-based game you can enter various commands to perform actions and interact with your surroundings.\nRight now the campus is in trouble- and it's your job to save it.\nHow do you save the campus? Well, that's up to you to find out- but you can start by talking with the Elf in the forest. Have fun!\n";	
+}
+
+// Prompt the user for a command. Flushing here sends the whole
+// turn's output (and the prompt) in one go, instead of a line at a time
+void Game::prompt(){
+	*out << PROMPT << std::flush;
 }
 
 // Core game loop, takes user input for commands while in progress
 void Game::play(){
-	// Print message describing the game
-	std::cout << "Welcome to GVZork!\nIn this story-driven, text-based game you can enter various commands to perform actions and interact with your surroundings.\nRight now the campus is in trouble- and it's your job to save it.\nHow do you save the campus? Well, that's up to you to find out- but you can start by talking with the Elf in the forest. Have fun!" << std::endl;	
+	welcome();
 
 	// Loop while the game is still in progress
+	std::string user_input; // Reused every turn, so it only allocates when a line is longer than any before it
 	while (inProgress){
-		std::string user_input;
-		// In the loop, prompt the user for a command
-		std::cout << "\nWhat will you do next: ";
-		std::getline(std::cin, user_input);
-
-		// Split the user's input into a vector of words.
-		// Refered to cplusplus.com list of libraries to find this function/how to use it
-		std::vector<std::string> tokens;
-		boost::split(tokens, user_input, boost::is_any_of(" ")); // Split user_input by spaces, add into tokens.
-		// Now create variable command to be equal to first element in the vector
-		std::string command = tokens[0]; // Make sure this actually sets the string and not to an address
-		tokens.erase(tokens.begin()); // Now remove the first element
-		
-		// Now check the command and call it's method
-		auto it = commands.find(command);
-		if (it != commands.end()) {
-			it->second(tokens);
+		prompt();
+		// Stop if the input stream is closed, otherwise the loop would spin forever on empty input
+		if (!std::getline(std::cin, user_input)){
+			break;
+		}
+		run_command(user_input);
+	}
+	// Send the last turn's output
+	*out << std::flush;
+}
+
+// The same loop as play, suspending for each line instead of reading it
+GameLoop Game::play_async(){
+	welcome();
+	while (inProgress){
+		prompt();
+		std::optional<std::string_view> user_input = co_await GameLoop::NextLine();
+		// Stop if the input was closed, the same as play at the end of std::cin
+		if (!user_input){
+			break;
+		}
+		run_command(*user_input);
+	}
+	// Send the last turn's output
+	*out << std::flush;
+}
+
+// Split one line of input into a command and target, and call the command's method
+void Game::run_command(std::string_view user_input){
+	if (events != nullptr){
+		events->turn();
+	}
+	// Split the user's input into words, as views into user_input.
+	std::span<const std::string_view> tokens = tokenizer.split(user_input);
+	// The first word is the command, and the rest are the target
+	std::string_view command = tokens[0];
+	
+	// Now find the command in the command table and call it's method
+	const Command* found = find_command(command);
+	if (found == nullptr){
+		found = resolve_command(command);
+	}
+	if (found != nullptr) {
+		if (shared && shared->locks){
+			// Commands only change the room the player starts in, so its lock covers them, even ones that move the player
+			std::lock_guard<RoomLock> guard(shared->locks[currentLocation]);
+			(this->*(found->handler))(tokens.subspan(1));
 		} else {
-			std::cout << "Invalid command." << std::endl;
-		}		
+			(this->*(found->handler))(tokens.subspan(1));
+		}
+	} else {
+		*out << "Invalid command.\n";
 	}
 }
 
+// Returns whether the game is still in progress
+bool Game::is_in_progress() const{
+	return inProgress;
+}
+
+// Returns the index of the player's location
+int Game::current_location() const{
+	return currentLocation;
+}
+
 // Prints date and time, help message, and all possible commands
-void Game::show_help(std::vector<std::string> target){
+void Game::show_help(std::span<const std::string_view> target){
 	// Print out date and time, using std::time from <ctime>. Found through cppreference documentation.
 	std::time_t currentTime = std::time(nullptr); // Returns the current calendar time (time since epoch) as a time_t object.
 						      // Also stores it in the object pointed to by arg- we can
 						      // pass null here since we don't need to store it in any object.
-	std::cout << std::asctime(std::localtime(&currentTime)) << std::endl; // asctime converts the time into a nice format
+	*out << std::asctime(std::localtime(&currentTime)) << "\n"; // asctime converts the time into a nice format
 									      // Local time converts the time_t into a local calendar time
 
-	// Print out help message and all commands frm command map's keys
-	std::cout << "Confused on how to play? Here are all the commands you can enter: " << std::endl;
-	// Print commands from command map's keys
-	std::map<std::string, std::function<void(std::vector<std::string> target)> >::iterator it = commands.begin();
-	while (it != commands.end()){
-	std::cout << it->first << std::endl;
-	++it;
+	// Print out help message and all commands from the command table
+	*out << "Confused on how to play? Here are all the commands you can enter: \n";
+	// Print command names from the command table (already in alphabetical order)
+	for (const Command& command : COMMAND_TABLE){
+		*out << command.name << "\n";
 	}
-	std::cout << "Make sure your format your answers as a one word command and then a single target- ex. take bag of chips\nAlso- make sure your capitalization and spacing matches!" << std::endl; 	
+	*out << "Make sure your format your answers as a one word command and then a single target- ex. take bag of chips\nCapitalization and spacing don't matter, and names can be shortened (ex. take bag of ch) or have a small typo.\n"; 	
 } 
 
 // Quits the game
-void Game::quit(std::vector<std::string> target){
-	std::cout << "You gave up before reaching the end. Quitting.";
+void Game::quit(std::span<const std::string_view> target){
+	*out << "You gave up before reaching the end. Quitting.";
 	inProgress = false;
+	if (events != nullptr){
+		events->end();
+	}
 }
 
 // Talk to the target NPC (cycle through their messages)
-void Game::talk(std::vector<std::string> target){
+void Game::talk(std::span<const std::string_view> target){
 	// Check if the provided NPC (target) is in the current room.
 	// Join target as a single string
-	std::string targetString = boost::algorithm::join(target, " "); // Code to join the vector of words from chatGPT
-	bool validTarget = false; // This will be used to print if the user entered an invalid target; used a new
-							  // variable for this outside the for loop so the invalid target message will only be printed once.
-	// Loop through location's NPC vector to check if the target exists in it
-	for (auto j = worldLocations[currentLocation].locationNPCs.begin(); j != worldLocations[currentLocation].locationNPCs.end(); ++j){
-		if (targetString == j->name){
-			// Call NPC's get_message method and print
-			std::cout << j->name << ": " << j->getCurrentMessage() << std::endl;
-			validTarget = true;
-			} 
-		}
-	if (!validTarget){
-		std::cout << "Invalid target. Make sure to match the spaces, capitalization, and spelling." << std::endl;
-	}	
+	std::string_view targetString = CommandTokenizer::join(target); // The words of the target, spaces included, without copying
+	const Location& room = world->locations[currentLocation];
+	// Find the NPC in the location by name
+	int npc = resolve_npc(room, targetString); // Slot of the NPC meant, -1 if none
+	if (npc < 0){
+		*out << INVALID_TARGET;
+		return;
+	}
+	int targetId = room.locationNPCs[npc].nameId;
+	// Call NPC's get_message method with the message this game is on, and print
+	int& messageNum = state->npcs[world->npc_number(currentLocation, npc)].messageNum;
+	if (events != nullptr){
+		events->talk(currentLocation, npc, messageNum);
+	}
+	*out << SymbolTable::global().name(targetId) << ": " << room.locationNPCs[npc].getCurrentMessage(messageNum) << "\n";
 }
 
 // Get the targetted NPC's description
-void Game::meet(std::vector<std::string> target){
+void Game::meet(std::span<const std::string_view> target){
 	// Join target as a single string
-	std::string targetString = boost::algorithm::join(target, " "); // Code to join the vector of words from chatGPT
-	bool validTarget = false; // This will be used to print if the user entered an invalid target; used a new
-							  // variable for this outside the for loop so the invalid target message will only be printed once.
+	std::string_view targetString = CommandTokenizer::join(target); // The words of the target, spaces included, without copying
+	const Location& room = world->locations[currentLocation];
 	// Check if the provided NPC exists in the current room
-	for (auto j = worldLocations[currentLocation].locationNPCs.begin(); j != worldLocations[currentLocation].locationNPCs.end(); ++j){
-			if (targetString == j->name){
-				// Call NPC's get_description method and print
-				std::cout << j->description << std::endl;
-				validTarget = true;
-			}
-		}
-	if (!validTarget){
-		std::cout << "Invalid target. Make sure to match the spaces, capitalization, and spelling." << std::endl;
+	int npc = resolve_npc(room, targetString); // Slot of the NPC meant, -1 if none
+	if (npc < 0){
+		*out << INVALID_TARGET;
+		return;
 	}
+	// Call NPC's get_description method and print
+	*out << room.locationNPCs[npc].description << "\n";
 }
 
 // Take the targetted item from the room, adding it to player inventory
-void Game::take(std::vector<std::string> target){
+void Game::take(std::span<const std::string_view> target){
 	// Join target as a single string
-	std::string targetString = boost::algorithm::join(target, " "); // Code to join the vector of words from chatGPT
-	bool validTarget = false; // This will be used to print if the user entered an invalid target; used a new
-							  // variable for this outside the for loop so the invalid target message will only be printed once.
+	std::string_view targetString = CommandTokenizer::join(target); // The words of the target, spaces included, without copying
+	const ItemStore& store = world->items;
+	// Read only, so a miss doesn't copy the room's state
+	int targetId = resolve_name(targetString, [&store, this](int id){ return std::as_const(*state).find_item(currentLocation, id, store) >= 0; }, [&store, this](std::vector<int>& ids){
+		for (ItemHandle item : std::as_const(*state).items(currentLocation)){
+			ids.push_back(store.name_id(item));
+		}
+	}); // Symbol ID of the item meant, -1 if none
 	// Check if the provided item exists in the current room
-	// Using an int instead of iterator here (although it seems more complicated) because using an iterator threw errors when removing the item.
-	for (int i = 0; i < worldLocations[currentLocation].locationItems.size(); ++i){
-		if (targetString == worldLocations[currentLocation].locationItems[i].name){
-			// Add item to user's inventory
-			items.push_back(worldLocations[currentLocation].locationItems[i]);
-			// Add to the user's weight
-			weight += worldLocations[currentLocation].locationItems[i].weight;
-			// Remove the item from the room's inventory
-			worldLocations[currentLocation].locationItems.erase(worldLocations[currentLocation].locationItems.begin() + i);
-			validTarget = true;	
-		}	
+	int slot = std::as_const(*state).find_item(currentLocation, targetId, store);
+	if (slot < 0){
+		*out << INVALID_TARGET;
+		return;
 	}
-	if (!validTarget){
-		std::cout << "Invalid target. Make sure to match the spaces, capitalization, and spelling." << std::endl;
+	if (events != nullptr){
+		events->take(currentLocation, slot, state->items(currentLocation)[slot]);
 	}
+	// Move the item from the room to the user's inventory (only the handle moves),
+	// which adds its weight and calories to the inventory's totals
+	state->take_item(currentLocation, slot, store, inventory);
 }
 
 // Give the targetted item from the user's inventory to
 // the current location. If you are in the woods, feeds the
 // elf and checks for the win condition.
-void Game::give(std::vector<std::string> target){	
+void Game::give(std::span<const std::string_view> target){	
 	// Join target as a single string
-	std::string targetString = boost::algorithm::join(target, " "); // Code to join the vector of words from chatGPT
-	bool validTarget = false; // Used to print if the user entered an invalid target. Used a new variable
-							  // for this outside the for loop so the invalid target message will only display once.	
+	std::string_view targetString = CommandTokenizer::join(target); // The words of the target, spaces included, without copying
+	const ItemStore& itemStore = world->items;
+	int targetId = resolve_name(targetString, [this, &itemStore](int id){
+		for (ItemHandle item : inventory.items()){
+			if (itemStore.name_id(item) == id){
+				return true;
+			}
+		}
+		return false;
+	}, [this, &itemStore](std::vector<int>& ids){
+		for (ItemHandle item : inventory.items()){
+			ids.push_back(itemStore.name_id(item));
+		}
+	}); // Symbol ID of the carried item meant, -1 if none
 	// Check if item exists in user's inventory
-	for (int i = 0; i < items.size(); ++i){
-		if (targetString == items[i].name){
-			// Add item to room
-			worldLocations[currentLocation].add_item(items[i]);
-			// Remove item and weight from player inventory
-			items.erase(items.begin() + i);
-			weight -= items[i].weight;
-			// Check if current location is the woods
-			if (worldLocations[currentLocation].name == "The Woods"){
-				// Check if item was edible
-				if (worldLocations[currentLocation].locationItems.back().calories > 0){
-					// Remove the calories from the amount still needed to win
-					winningCalories -= worldLocations[currentLocation].locationItems.back().calories;
-					// Check for win condition
-					if (winningCalories <= 0){
-						std::cout << "Congrats! You win." << std::endl;
-						inProgress = false;
-					} else {
-						std::cout << "Elf: I'm still hungry... I could use, say, " << winningCalories << " more calories... Just a rough estimate." << std::endl;
-					}
-					// If items was edible, erase it from the room as well
-					worldLocations[currentLocation].locationItems.pop_back();	
-				} else { // If item was not edible, TP player randomly
-					std::cout << "Elf: Gah! I can't eat this. Find me real food!\n*The elf waves their wand, and you are teleported away*" << std::endl;
-					worldLocations[currentLocation].alreadyVisited = true; // Make sure location is set to visited before being teleported to a new one
-					currentLocation = random_location(); // Teleport to random location
-				}	
+	for (int i = 0; i < inventory.size(); ++i){
+		ItemHandle item = inventory.items()[i];
+		if (targetId == itemStore.name_id(item)){
+			// Check if current location is the woods (where the Elf is), and the item is edible
+			if (currentLocation == world->elfLocation && itemStore.calories(item) > 0){
+				if (events != nullptr){
+					events->eat(i, item);
+				}
+				// The Elf eats the item, so it leaves the inventory without going anywhere else
+				inventory.remove(itemStore, state->slots, i);
+				// Remove the calories from the amount still needed to win
+				winningCalories -= itemStore.calories(item);
+				// Check for win condition
+				if (winningCalories <= 0){
+					*out << "Congrats! You win.\n";
+					inProgress = false;
+				} else {
+					*out << "Elf: I'm still hungry... I could use, say, " << winningCalories << " more calories... Just a rough estimate.\n";
+				}
+				return;
 			}
-		validTarget = true;
+			if (events != nullptr){
+				events->give(currentLocation, i, item);
+			}
+			// Move the item from the inventory to the room
+			state->drop_item(currentLocation, itemStore, inventory, i);
+			// If the item was not edible, the Elf TPs the player randomly
+			if (currentLocation == world->elfLocation){
+				*out << "Elf: Gah! I can't eat this. Find me real food!\n*The elf waves their wand, and you are teleported away*\n";
+				state->set_visited(currentLocation); // Make sure location is set to visited before being teleported to a new one
+				int from = currentLocation;
+				currentLocation = random_location(); // Teleport to random location
+				if (events != nullptr){
+					events->teleport(from, currentLocation, true);
+				}
+			}
+			return;
 		}
 	}
-	if (!validTarget){
-		std::cout << "Invalid target. Make sure to match the spaces, capitalization, and spelling." << std::endl;	
-	}
+	*out << INVALID_TARGET;	
 }
 
 // Travel to a new location at the targetted direction
-void Game::go(std::vector<std::string> target){
+void Game::go(std::span<const std::string_view> target){
 	// Set current location visited status to true
-	worldLocations[currentLocation].alreadyVisited = true;
-	// Check if player has over 30 weight
-	if (weight > 30){
-		std::cout << "Your backpack is too heavy to travel anywhere else; please drop some items if you wish to move on." << std::endl;
+	state->set_visited(currentLocation);
+	// Check if player has over 30 weight (compared exactly, in hundredths of a pound)
+	if (inventory.weight_units() > 30 * WEIGHT_UNITS_PER_POUND){
+		*out << "Your backpack is too heavy to travel anywhere else; please drop some items if you wish to move on.\n";
+		if (events != nullptr){
+			events->go(currentLocation, currentLocation);
+		}
 		return;
 	}
-	// Check if provided direction exists in the current location's neighbor map
+	// Check if provided direction exists out of the current location
 	// Join target as a single string
-	std::string targetString = boost::algorithm::join(target, " "); // Code to join the vector of words from chatGPT
-	bool validTarget; // Used to print a message if an invalid target was entered.
-					  // Using a new variable here instead of in the for loop so it only prints once.
-	// Loop through location's neighbor map (keys for direction- north, east, south, west) and check it to targetString
-	int indexNum = 0; 
-	for (auto i = worldLocations[currentLocation].neighborsMap.begin(); i != worldLocations[currentLocation].neighborsMap.end(); ++i){
-		if (targetString == i->first){
-			// Now find what index the next direction is at in worldLocations vector -- code for this loop and inside from chatGPT
-			for (indexNum = 0; indexNum < worldLocations.size(); ++indexNum){
-				if (&(worldLocations[indexNum]) == &(i->second.get())){
-					break;
-				}
-			}
-		validTarget = true;
+	std::string_view targetString = CommandTokenizer::join(target); // The words of the target, spaces included, without copying
+	// Find the direction meant among the ones out of here, then the location in that direction from the world graph
+	const WorldGraph& graph = world->graph;
+	int direction = resolve_name(targetString, [this, &graph](int id){ return graph.neighbor(currentLocation, id) >= 0; }, [this, &graph](std::vector<int>& ids){
+		for (int e = graph.edges_begin(currentLocation); e < graph.edges_end(currentLocation); e++){
+			ids.push_back(graph.edge_direction(e));
+		}
+	});
+	int indexNum = (direction < 0) ? -1 : graph.neighbor(currentLocation, direction);
+	if (indexNum < 0){
+		*out << INVALID_TARGET;
+		if (events != nullptr){
+			events->go(currentLocation, currentLocation);
 		}
+		return;
 	}
-	if (!validTarget){
-	std::cout << "Invalid target. Make sure to match the spaces, capitalization, and spelling." << std::endl;
-	return;
+	if (events != nullptr){
+		events->go(currentLocation, indexNum);
 	}
-        currentLocation = indexNum;	
+	currentLocation = indexNum;
 }
 
 // Print the player's inventory and weight
-void Game::show_items(std::vector<std::string> target){
+void Game::show_items(std::span<const std::string_view> target){
 	// Print all items the player is carrying
-	std::cout << "You are carrying the following items: " << std::endl;
-	for (auto i = items.begin(); i!= items.end(); ++i){
-		std::cout << *i;
+	*out << "You are carrying the following items: \n";
+	for (ItemHandle item : inventory.items()){
+		world->items.print(*out, item);
 	}
 	// Print out coins amount
-	std::cout << "You have " << coins << " coins. Spend them wisely!" << std::endl;
+	*out << "You have " << coins << " coins. Spend them wisely!\n";
 	// Print out current weight
-	std::cout << "The current weight you are carrying is: " << weight << std::endl;
+	*out << "The current weight you are carrying is: " << inventory.weight() << "\n";
+	// Print out the food's total calories
+	*out << "The food you are carrying has " << inventory.calories() << " calories.\n";
 }
 
 // Print details about the current location
-void Game::look(std::vector<std::string> target){
-	std::cout << worldLocations[currentLocation] << std::endl;
+void Game::look(std::span<const std::string_view> target){
+	// Formatted again only if the location changed since the last look
+	const std::string& text = state->render(currentLocation, *world);
+	out->write(text.data(), text.size());
 }
 
 // Extra command - allows the player to buy a random food item
 // with coins from one of the shopkeeper NPCs (pod store employee and vending machine)
-void Game::buy(std::vector<std::string> target){
+void Game::buy(std::span<const std::string_view> target){
 	// Target = specific NPC (vending machine or employee)
 	// Join target as a single string
-	std::string targetString = boost::algorithm::join(target, " "); // Code to join the vector of words from chatGPT
-	bool validTarget = false; // Used to print if the user entered an invalid target
-	// Loop through the room's NPCs to check if a valid NPC was targeted
-	for (auto i = worldLocations[currentLocation].locationNPCs.begin(); i != worldLocations[currentLocation].locationNPCs.end(); ++i){
-		if (targetString == i->name){
-			// Return if the NPC isn't one of the ones you can buy from.
-			if (i->name != "Vending machine" && i->name != "Employee"){
-				std::cout << "They aren't selling anything." << std::endl;
-				return;
-			}
-			// Check that shopItems vector isn't empty (that all items have not been bought already)
-			if (shopItems.empty()){
-				std::cout << "They have nothing more to sell." << std::endl;
-				return;
-			}
-			// Check that user has enough coins
-			if (coins < 25){
-				std::cout << "You don't have enough coins. 25 coins a pop." << std::endl;
-				return;
-			}
-			// Remove coins from player's inventory
-			coins -= 25;
-			// Add the bought item to inventory
-			items.push_back(shopItems[0]);
-			// Add weight
-			weight += shopItems[0].weight;
-			// Print message about item bought
-			std::cout << "For 25 coins, you bought a: " << shopItems[0].name << std::endl;
-			// Remove the item from the shopItem vector
-			shopItems.erase(shopItems.begin());
-			validTarget = true;
-		} 
+	std::string_view targetString = CommandTokenizer::join(target); // The words of the target, spaces included, without copying
+	const Location& room = world->locations[currentLocation];
+	// Check that the targeted NPC is in the room
+	int npc = resolve_npc(room, targetString); // Slot of the NPC meant, -1 if none
+	if (npc < 0){
+		*out << INVALID_TARGET;
+		return;
 	}
-	if (!validTarget){
-	std::cout << "Invalid target. Make sure to match the spaces, capitalization, and spelling." << std::endl;
+	int targetId = room.locationNPCs[npc].nameId;
+	// Return if the NPC isn't one of the ones you can buy from.
+	if (targetId != VENDING_MACHINE && targetId != EMPLOYEE){
+		*out << "They aren't selling anything.\n";
+		return;
+	}
+	// Check that all items have not been bought already
+	if (state->shopItemsSold >= world->shopCount){
+		*out << "They have nothing more to sell.\n";
+		return;
+	}
+	// Check that user has enough coins
+	if (coins < 25){
+		*out << "You don't have enough coins. 25 coins a pop.\n";
+		return;
 	}
+	// Take the next item off the shelf. In a shared world, another player may have bought the last one since the check above
+	int sold = state->sell_shop_item(world->shopCount);
+	if (sold < 0){
+		*out << "They have nothing more to sell.\n";
+		return;
+	}
+	// Remove coins from player's inventory
+	coins -= 25;
+	// Print message about item bought
+	ItemHandle bought = world->shopStart + sold;
+	if (events != nullptr){
+		events->buy(sold, bought);
+	}
+	*out << "For 25 coins, you bought a: " << SymbolTable::global().name(world->items.name_id(bought)) << "\n";
+	// Add the bought item to the inventory (and its weight to the inventory's)
+	inventory.add(world->items, state->slots, bought);
 }
 
 // Extra command - allows the player to pickpocket the 
 // targetted NPC for coins; however, comes with a risk of getting caught!
-void Game::steal(std::vector<std::string> target){
+void Game::steal(std::span<const std::string_view> target){
 	// Join target as a single string
-	std::string targetString = boost::algorithm::join(target, " ");
-	bool validTarget = false; // Used to print if the user entered an invalid target
-	// Loop through the room's NPCs to check if a valid NPC was targeted
-	for (auto i = worldLocations[currentLocation].locationNPCs.begin(); i != worldLocations[currentLocation].locationNPCs.end(); ++i){
-		if (targetString == i->name){
-			// Check that the NPC isn't one you cannot steal from (cannot use steal on vending machine, podstore employee, and elf)
-			if (i->name == "Vending machine" || i->name == "Employee"){
-				std::cout << "You cannot steal from them." << std::endl;
-				return;
-			}
-			// Stealing from the Elf is a bad idea.
-			if (i->name == "Elf"){
-				std::cout << "Elf: YOU DARE?!?!\n*The Elf strikes you with lightning...* GAME OVER." << std::endl;
-				inProgress = false;
-				return;
-			}
-			// Using random_location function to generate a random number between 0 and 9.
-			int randomChance = random_location();
-			if (randomChance == 2 || randomChance == 5 || randomChance == 7 || randomChance == 0 || randomChance == 1){ // 5/10 - 50% chance of being caught and teleported.
-				std::cout << i->name << ": HEY! What do you think you're doing?!?! SECURITY!" << std::endl;
-				std::cout << "*Security escorts you away...*" << std::endl;			
-				worldLocations[currentLocation].alreadyVisited = true; // Make sure current location is set to visited before changing it
-				currentLocation = 6; // index for campus security location
-				return;
-				}
-				// Can't steal from someone twice - check if they've been robbed yet	
-				if (i->robbed){
-					std::cout << "You already stole from them... how heartless are you?!?!" << std::endl;
-					return;
-				}	
-				// Using the same randomly generated number to decide how many coins to give.
-				if (randomChance == 1){ 
-					std::cout << "Success! You have stolen 10 coins. Not bad." << std::endl;
-					coins += 10;
-					i->robbed = true;
-				} else if (randomChance == 4 || randomChance == 6 || randomChance == 9){
-					std::cout << "Oh... they don't have much. You stole 5 coins." << std::endl;
-					coins += 5;
-					i->robbed = true;
-				} else {
-					std::cout << "Score! Their wallet is packed. You stole 15 coins." << std::endl;
-					coins += 15;
-					i->robbed = true;
-				}
-		validTarget = true;	
+	std::string_view targetString = CommandTokenizer::join(target); // The words of the target, spaces included, without copying
+	const Location& room = world->locations[currentLocation];
+	// Check that the targeted NPC is in the room
+	int npc = resolve_npc(room, targetString); // Slot of the NPC meant, -1 if none
+	if (npc < 0){
+		*out << INVALID_TARGET;
+		return;
+	}
+	int targetId = room.locationNPCs[npc].nameId;
+	// Check that the NPC isn't one you cannot steal from (cannot use steal on vending machine, podstore employee, and elf)
+	if (targetId == VENDING_MACHINE || targetId == EMPLOYEE){
+		*out << "You cannot steal from them.\n";
+		return;
+	}
+	// Stealing from the Elf is a bad idea.
+	if (targetId == ELF){
+		*out << "Elf: YOU DARE?!?!\n*The Elf strikes you with lightning...* GAME OVER.\n";
+		inProgress = false;
+		if (events != nullptr){
+			events->end();
 		}
+		return;
 	}
-	if (!validTarget){
-	std::cout << "Invalid target. Make sure to match the spaces, capitalization, and spelling." << std::endl;
+	// Using steal_roll function to generate a random number between 0 and 9.
+	int randomChance = steal_roll();
+	int victim = world->npc_number(currentLocation, npc);
+	if (randomChance == 2 || randomChance == 5 || randomChance == 7 || randomChance == 0 || randomChance == 1){ // 5/10 - 50% chance of being caught and teleported.
+		*out << SymbolTable::global().name(targetId) << ": HEY! What do you think you're doing?!?! SECURITY!\n";
+		*out << "*Security escorts you away...*\n";
+		if (events != nullptr){
+			events->steal(victim, randomChance, 0);
+			events->teleport(currentLocation, world->securityLocation, false);
+		}
+		state->set_visited(currentLocation); // Make sure current location is set to visited before changing it
+		currentLocation = world->securityLocation; // index for campus security location
+		return;
+	}
+	// Can't steal from someone twice - check if they've been robbed yet
+	if (std::as_const(*state).npcs[victim].robbed){
+		*out << "You already stole from them... how heartless are you?!?!\n";
+		if (events != nullptr){
+			events->steal(victim, randomChance, 0);
+		}
+		return;
 	}
+	// Using the same randomly generated number to decide how many coins to give.
+	int stolen;
+	if (randomChance == 1){
+		*out << "Success! You have stolen 10 coins. Not bad.\n";
+		stolen = 10;
+	} else if (randomChance == 4 || randomChance == 6 || randomChance == 9){
+		*out << "Oh... they don't have much. You stole 5 coins.\n";
+		stolen = 5;
+	} else {
+		*out << "Score! Their wallet is packed. You stole 15 coins.\n";
+		stolen = 15;
+	}
+	if (events != nullptr){
+		events->steal(victim, randomChance, stolen);
+	}
+	coins += stolen;
+	state->npcs[victim].robbed = true;
 }
-
-
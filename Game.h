@@ -3,23 +3,38 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <span>
 #include <vector>
-#include <map>
-#include <functional>
+#include <cstdint>
+#include <memory>
 
 #include "Item.h"
+#include "ItemStore.h"
+#include "Inventory.h"
 #include "NPC.h"
 #include "Location.h"
+#include "WorldGraph.h"
+#include "World.h"
+#include "WorldDefinition.h"
+#include "WorldState.h"
+#include "SharedWorld.h"
+#include "CommandTokenizer.h"
+#include "Random.h"
+#include "GameLoop.h"
+
+class EventLog;
 
 /*
  * Header for Game.cpp. Game has the values for
- * the current game and player- a map of commands, a vector of items
- * in the player's inventory, the player's weight, a vector
- * of all the locations in this world, an index for this vector
+ * the current game and player- the player's inventory
+ * (items, with their total weight and calories), the world
+ * (its definition, shared with every other game in it, and the
+ * state this game has changed it to), an index
  * representing the current location, the amount of calories left to win,
- * an in progress boolean, amount of coins the user has, and a vector holding
- * items in the shops.
- * Includes constructor, methods to create the world, set up the commands map,
+ * an in progress boolean, and amount of coins the user has.
+ * The commands the player can enter are in the COMMAND_TABLE (CommandTable.h).
+ * Includes constructor, methods to create the world,
  * get a random number for getting a random location, a play method for the main
  * game loop, and multiple command methods such as go, talk, give, etc. to perform
  * actions and interact with the game world.
@@ -30,82 +45,243 @@
 
 class Game{
 	private:
-		// Map of user entered strings to refer to aliases of functions to be called-
-		// so user can input a command and have that method called without a bunch of if statements.
-		// Used ChatGPT to help determine what type to use for the function aliases.
-		std::map<std::string, std::function<void(std::vector<std::string> target)>> commands; 
-		std::vector<Item> items; // Items the player currently has in inventory
-		int weight; // Current weight the player is carrying
-		std::vector<Location> worldLocations; // Locations that exist in the world
-		int currentLocation; // Index for worldLocations vector to represent the current location
+		CommandTokenizer tokenizer; // Splits input lines into words; reused so a turn doesn't allocate
+		Inventory inventory; // Items the player currently has, with their total weight and calories
+		std::shared_ptr<const WorldDefinition> world; // The locations, items, and directions, shared with every game in the world
+		std::shared_ptr<WorldState> state; // What this game has changed about the world (its own, or every player's in a SharedWorld)
+		std::shared_ptr<SharedWorld> shared; // The shared world the game is a player in, or nullptr if the state is the game's own
+		int currentLocation; // Index of the world location the player is in
 		int winningCalories; // The amount of calories the elf needs before it will save the campus (win condition)
 		bool inProgress; // Boolean that stores whether the game is still in progress
 		int coins; // Added coins variable for some extra fun commands. You can use coins to buy food from shop-keepers
-		std::vector<Item> shopItems; // Added shop items vector for some extra fun commands. Holds some food items you can buy
-		// Adding Location as a friend so Location can access game's private variables if needed
+		std::ostream* out; // Where the game writes everything it prints (std::cout unless another stream was given, ex. an OutputSink's)
+		Random rng; // Random number generator for teleports and stealing, seeded once when the game is made
+		EventLog* events; // The log the game records what happens in (see EventLog.h), or nullptr if it isn't recording
+		/*
+		 * resolve_npc finds the NPC in a room the player meant by a
+		 * command's target, matching names loosely like the other commands.
+		 *
+		 * Args:
+		 * room, the room to look for the NPC in
+		 * text, the target the player typed
+		 *
+		 * Returns:
+		 * The NPC's index in the room's NPCs, or -1 if nothing (or more
+		 * than one NPC) matched.
+		 */
+		static int resolve_npc(const Location& room, std::string_view text);
+		// Adding Location and Simulator as friends so they can access game's private variables if needed
 		// without getters and setters
 		friend class Location;
+		friend class Simulator;
+		friend class Snapshot;
+		friend class SharedWorld;
+		friend class EventReplayer;
 	public:
 		/*
 		 * Default constructor
-		 * Sets up the commands vector, creates the world,
+		 * Creates the world,
 		 * sets up the world locations vector, sets the winning
 		 * calories value, and sets the other attributes (weight, coins,
 		 * etc.) to 0. Sets inProgress to true, and gets a random location
-		 * to start.
+		 * to start. The random number generator gets a random seed.
 		 */
 		Game(); 
 		/*
-		 * create_world creates all the locations, items, and NPCs in the game.
-		 * Adds the locations to a vector of all the world's locations.
-		 * 
+		 * Constructor that plays in the given world instead of
+		 * the built-in one (ex. a world read in by WorldLoader).
+		 * Otherwise the same as the default constructor.
+		 *
+		 * Args:
+		 * The world to play in. To start many games in one world,
+		 * make a WorldDefinition of it once and share that instead.
+		 */
+		Game(World world);
+		/*
+		 * Constructor that plays in the given world with a fixed seed
+		 * for the random number generator. Two games made with the same
+		 * world and seed play out the same for the same commands,
+		 * including the starting location.
+		 *
+		 * Args:
+		 * world, the world to play in
+		 * seed, the seed for the random number generator
+		 */
+		Game(World world, std::uint64_t seed);
+		/*
+		 * Constructor that plays in the given world with a fixed seed,
+		 * and writes all of the game's output to the given stream instead
+		 * of std::cout. Usually the stream of an OutputSink (see OutputSink.h),
+		 * ex. buffered stdout when playing, or a NullSink in the simulator.
+		 *
+		 * Args:
+		 * world, the world to play in
+		 * seed, the seed for the random number generator
+		 * output, the stream to write output to; it must outlive the game
+		 */
+		Game(World world, std::uint64_t seed, std::ostream& output);
+		/*
+		 * Constructor that plays in a world shared with other games, with
+		 * a fixed seed, writing output to the given stream. Starting a game
+		 * this way costs the same whatever the size of the world, and the
+		 * game only takes memory for what it changes (see WorldState.h),
+		 * so one process can keep thousands of games going at once.
+		 *
+		 * Args:
+		 * world, the world to play in; the game keeps it alive
+		 * seed, the seed for the random number generator
+		 * output, the stream to write output to; it must outlive the game
+		 */
+		Game(std::shared_ptr<const WorldDefinition> world, std::uint64_t seed, std::ostream& output);
+		/*
+		 * Constructor for a player in a shared world (see SharedWorld.h),
+		 * who sees and changes the same world as every other player in it,
+		 * and can run commands at the same time as them on other threads.
+		 * Each player has their own inventory, location, and coins.
+		 *
+		 * Args:
+		 * world, the world to play in; the game keeps it alive
+		 * seed, the seed for the random number generator
+		 * output, the stream to write output to; it must outlive the game
+		 */
+		Game(std::shared_ptr<SharedWorld> world, std::uint64_t seed, std::ostream& output);
+		/*
+		 * fork makes a copy of the game as it is now, which plays on from
+		 * this turn independently of the original (ex. to try out different
+		 * commands from the same point). The copy shares the world's state
+		 * with the original until either of them changes something, so forking
+		 * costs about the same whatever the size of the world, and playing
+		 * the fork only copies the parts of the state it changes.
+		 * The fork draws the same random numbers as the original would.
+		 * It doesn't record into the original's event log.
+		 * Games in a SharedWorld can't be forked (std::invalid_argument).
+		 *
+		 * Args:
+		 * The stream the fork writes its output to; it must outlive the fork.
+		 *
 		 * Returns:
-		 * A vector of all the world locations.
+		 * The fork.
 		 */
-		std::vector<Location> create_world();
+		Game fork(std::ostream& output) const;
 		/*
-		 * setup_commands creates the map of possible
-		 * user inputs (ex. give, go, etc.) and the methods they refer to.
-		 * Used ChatGPT to help determine what type to use for the values
-		 * in the map, the function aliases.
+		 * record_events starts recording everything that happens in the
+		 * game into an event log (see EventLog.h), starting with a snapshot
+		 * of the game as it is now, so an EventReplayer can rebuild it at
+		 * any turn from here on. Several games can record into one log one
+		 * after another, but only one at a time. Games in a SharedWorld
+		 * can't be recorded (std::invalid_argument), since other players
+		 * change their state without recording it.
+		 *
+		 * Args:
+		 * The log to record into, which must outlive the recording, or
+		 * nullptr to stop recording.
+		 */
+		void record_events(EventLog* log);
+		/*
+		 * create_world creates all the locations, items, and NPCs in the
+		 * built-in campus world. Adds the locations to a vector of all the
+		 * world's locations, builds the world graph of directions between them,
+		 * and sets up the shop items.
 		 * 
 		 * Returns:
-		 * The map of strings and the function aliases they refer to.
+		 * The built-in world.
 		 */
-		std::map<std::string, std::function<void(std::vector<std::string> target)>> setup_commands();
+		static World create_world();
 		/*
 		 * random_location generates a random number within the number of
 		 * locations in the world. This can be used to get a random location
-		 * from the world.
-		 * Used ChatGPT for the code inside this method and for the functions 
-		 * to generate a random number in the specified range.
+		 * from the world. Draws from the game's random number generator.
 		 *
 		 * Returns:
 		 * A random integer between 0 and the amount of locations in the world.
-		 * Can be used as an index in the worldLocations vector to select a random location.
+		 * Can be used as an index in the world's locations to select a random location.
 		 */
 		int random_location();
+		/*
+		 * steal_roll generates the random number that decides how
+		 * a steal attempt goes. Draws from the game's random number generator.
+		 *
+		 * Returns:
+		 * A random integer from 0 to 9, each equally likely.
+		 */
+		int steal_roll();
+		// What prompt prints, the last thing the game writes before waiting for a command
+		static constexpr std::string_view PROMPT = "\nWhat will you do next: ";
+		// welcome prints the message describing the game, which play starts with
+		void welcome();
+		/*
+		 * prompt asks the user for the next command, and flushes the
+		 * output stream so the turn's output is sent all at once.
+		 * play and play_async do this every turn.
+		 */
+		void prompt();
 		/*
 		 * play is the core game loop. 
+		 * Reads commands from std::cin.
 		 * Prints a message describing the game,
 		 * then loops while the game is in progress.
 		 * Accepts user input for commands each loop.
 		 * Splits the user's input up into a command and
 		 * target.
 		 * Calls the command and passes it the target.
+		 * The input line is reused between turns.
 		 */
 		void play();
+		/*
+		 * play_async is the game loop of play as a coroutine (see GameLoop.h).
+		 * It prints the same welcome, prompts, and output as play, but
+		 * instead of reading std::cin it suspends for each line, until
+		 * the returned GameLoop feeds it one. Many games can be played
+		 * this way on one thread, each only taking memory while suspended.
+		 *
+		 * Returns:
+		 * The loop, already started and waiting for the first line.
+		 * The game must outlive it.
+		 */
+		GameLoop play_async();
+		/*
+		 * run_command runs a single line of user input through the
+		 * COMMAND_TABLE. Splits the line up into a command and target,
+		 * and calls the command's method with the target.
+		 * Used by play, and by the headless replay driver (Replay.cpp)
+		 * to feed commands in without going through std::cin.
+		 * The words are split out as views of the line, so the line
+		 * must not change until run_command returns; once the game is
+		 * warmed up, most commands run without any heap allocations.
+		 * In a SharedWorld, the command holds the lock of the player's
+		 * room while it runs (unless the world's rooms aren't locked).
+		 *
+		 * Args:
+		 * One line of user input.
+		 */
+		void run_command(std::string_view user_input);
+		/*
+		 * is_in_progress returns whether the game is still running
+		 * (the player hasn't won, lost, or quit yet).
+		 *
+		 * Returns:
+		 * True if the game is still in progress, false otherwise.
+		 */
+		bool is_in_progress() const;
+		/*
+		 * current_location returns where the player is, ex. for a
+		 * benchmark to pick targets that are in the player's room.
+		 *
+		 * Returns:
+		 * The index of the player's location in the world's locations.
+		 */
+		int current_location() const;
 		/*
 		 * show_help prints the current time, a help message,
 		 * and all of the possible user inputs
 		 * for commands (actions the player can make)
-		 * from the keys in the commands map.
+		 * from the names in the COMMAND_TABLE.
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void show_help(std::vector<std::string> target);
+		void show_help(std::span<const std::string_view> target);
 		/*
 		 * talk allows you to talk to the targetted NPC.
 		 * Checks if the provided NPC is in the current room,
@@ -113,62 +289,65 @@ class Game{
 		 * it out.
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void talk(std::vector<std::string> target);
+		void talk(std::span<const std::string_view> target);
 		/*
 		 * meet prints out a description of the targetted NPC,
 		 * if they exist in the room.
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void meet(std::vector<std::string> target);
+		void meet(std::span<const std::string_view> target);
 		/*
 		 * take checks if the target item is in the room,
 		 * and if so removes it from the rooms inventory and
-		 * adds it to the player's inventory.
+		 * adds it to the player's inventory. Only the item's handle
+		 * moves, and one item is taken per command.
 		 * It also adds the weight of the item to the player's weight.
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void take(std::vector<std::string> target);
+		void take(std::span<const std::string_view> target);
 		/*
 		 * give removes the targetted item and item's weight from the user's inventory,
-		 * if it exists, and adds it to the current location's inventory.
+		 * if it exists, and adds it to the current location's inventory (edible items
+		 * given to the Elf are eaten instead).
 		 * Also checks if the current location is the woods; if it is, checks if the item is edible,
 		 * if so- removes the calorie count from the amount left to win, and checks for a win condition.
 		 * If the item is not edible, the player is teleported to a random location by calling random_location().
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void give(std::vector<std::string> target); 
+		void give(std::span<const std::string_view> target); 
 		/*
 		 * go sets the current location to visited and then
 		 * changes your current location to be the one in the targetted
-		 * direction, if it exists.
+		 * direction, if it exists. The neighbor is looked up in the
+		 * world graph by index, so this doesn't depend on the world size.
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void go(std::vector<std::string> target);
+		void go(std::span<const std::string_view> target);
 		/*
 		 * show_items prints all items the player is carrying
-		 * as well as the amount of coins and current 
-		 * inventory weight.
+		 * as well as the amount of coins, current 
+		 * inventory weight, and calories of the food carried.
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void show_items(std::vector<std::string> target);
+		void show_items(std::span<const std::string_view> target);
 		/*
 		 * look prints the current location,
 		 * which from the overloaded location stream operator
@@ -176,45 +355,45 @@ class Game{
 		 * as well as neighboring locations and directions.
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void look(std::vector<std::string> target);
+		void look(std::span<const std::string_view> target);
 		/*
 		 * Quit allows the user to end the game.
 		 * Prints a failure message and sets in progress to false,
 		 * so the game ends.
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void quit(std::vector<std::string> target); 
+		void quit(std::span<const std::string_view> target); 
 		/*
 		 * buy allows the user to buy a random food item from the targetted shopkeeper
 		 * (the Pod Store employee or Vending Machine in Mackinac hall).
 		 * Takes 25 coins from the player's inventory and gives
-		 * one of the food items from the shopItems vector to the
-		 * player's inventory, while removing it from shopItems.
+		 * the next of the world's shop items to the
+		 * player's inventory (each can only be bought once).
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void buy(std::vector<std::string> target); 
+		void buy(std::span<const std::string_view> target); 
 		/*
 		 * steal allows the player to attempt to pick-pocket
 		 * the targetted NPC for coins. It has a 50% chance of success-
 		 * if it succeeds, the player is given a random amount of coins,
 		 * if it fails, the user is caught and teleported to the
 		 * Campus Security location.
-		 * Uses random_location() method for random number/chance generation.
+		 * Uses steal_roll() for random number/chance generation.
 		 *
 		 * Args:
-		 * A vector of the user's inputted words
+		 * A span of the user's inputted words
 		 * representing the target of the command.
 		 */
-		void steal(std::vector<std::string> target); 
+		void steal(std::span<const std::string_view> target); 
 };
 
 #endif
@@ -0,0 +1,90 @@
+#include "GameLoop.h"
+#include <utility>
+
+/*
+ * GameLoop owns a game loop coroutine, and resumes it with
+ * lines of input (see Game::play_async for the loop itself).
+ */
+
+GameLoop GameLoop::promise_type::get_return_object(){
+	return GameLoop(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+// Start running right away, up to the first co_await for a line
+std::suspend_never GameLoop::promise_type::initial_suspend() noexcept{
+	return {};
+}
+
+std::suspend_always GameLoop::promise_type::final_suspend() noexcept{
+	return {};
+}
+
+void GameLoop::promise_type::return_void(){
+}
+
+// Keep the exception for resume to rethrow; the loop has ended either way
+void GameLoop::promise_type::unhandled_exception(){
+	exception = std::current_exception();
+}
+
+// Always suspend: the line is only there once feed or close resumes the loop
+bool GameLoop::NextLine::await_ready() const noexcept{
+	return false;
+}
+
+void GameLoop::NextLine::await_suspend(std::coroutine_handle<promise_type> waiting) noexcept{
+	promise = &waiting.promise();
+}
+
+std::optional<std::string_view> GameLoop::NextLine::await_resume() const{
+	if (promise->inputClosed){
+		return std::nullopt;
+	}
+	return promise->line;
+}
+
+GameLoop::GameLoop(std::coroutine_handle<promise_type> handle) : handle(handle){
+}
+
+GameLoop::GameLoop(GameLoop&& other) noexcept : handle(std::exchange(other.handle, nullptr)){
+}
+
+GameLoop& GameLoop::operator=(GameLoop&& other) noexcept{
+	if (this != &other){
+		if (handle){
+			handle.destroy();
+		}
+		handle = std::exchange(other.handle, nullptr);
+	}
+	return *this;
+}
+
+GameLoop::~GameLoop(){
+	if (handle){
+		handle.destroy();
+	}
+}
+
+bool GameLoop::done() const{
+	return !handle || handle.done();
+}
+
+void GameLoop::resume(){
+	handle.resume();
+	if (handle.promise().exception){
+		std::rethrow_exception(std::exchange(handle.promise().exception, nullptr));
+	}
+}
+
+void GameLoop::feed(std::string_view line){
+	handle.promise().line = line;
+	resume();
+}
+
+void GameLoop::close(){
+	if (done()){
+		return;
+	}
+	handle.promise().inputClosed = true;
+	resume();
+}
@@ -0,0 +1,87 @@
+#ifndef __GAMELOOP_H__ // INCLUDE GUARD
+#define __GAMELOOP_H__
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string_view>
+
+/*
+ * Header file for GameLoop.cpp
+ * GameLoop is the handle to a game loop running as a C++20 coroutine
+ * (see Game::play_async). It is the same loop as Game::play, but instead
+ * of blocking on std::getline it suspends where it needs the next line,
+ * and whoever holds the GameLoop resumes it by feeding it one. So a
+ * waiting player costs the coroutine's frame (a few hundred bytes) plus
+ * their Game, instead of a whole thread blocked in a read, and one thread
+ * can keep thousands of games going by feeding each its lines as they
+ * come in (ex. SessionServer, or the coroutines benchmark).
+ *
+ * The loop runs on whichever thread feeds it, until it needs another line.
+ * By then the turn's output (ending with the prompt) has been written and
+ * flushed to the game's output stream, so that is where what the loop
+ * yields ends up, usually an OutputSink the caller drains after each line.
+ * The loop starts as soon as it's made: the welcome and first prompt are
+ * written before play_async returns.
+ */
+
+class GameLoop{
+	public:
+		// The coroutine's promise, which is how a line gets from feed to the loop
+		struct promise_type{
+			std::string_view line; // The line being fed
+			bool inputClosed = false; // Set by close, so the loop ends instead of waiting for more
+			std::exception_ptr exception; // Thrown by the loop, and rethrown by feed or close
+			GameLoop get_return_object();
+			std::suspend_never initial_suspend() noexcept;
+			std::suspend_always final_suspend() noexcept; // So done() can still be checked once the loop has ended
+			void return_void();
+			void unhandled_exception();
+		};
+		// What the loop co_awaits to get the next line; resumes with nothing once the input is closed
+		struct NextLine{
+			promise_type* promise = nullptr;
+			bool await_ready() const noexcept;
+			void await_suspend(std::coroutine_handle<promise_type> waiting) noexcept;
+			std::optional<std::string_view> await_resume() const;
+		};
+	private:
+		std::coroutine_handle<promise_type> handle;
+		// Constructor used by the promise, for the coroutine it belongs to
+		explicit GameLoop(std::coroutine_handle<promise_type> handle);
+		// Resume the loop, and rethrow anything it threw
+		void resume();
+	public:
+		GameLoop(GameLoop&& other) noexcept;
+		GameLoop& operator=(GameLoop&& other) noexcept;
+		GameLoop(const GameLoop&) = delete;
+		GameLoop& operator=(const GameLoop&) = delete;
+		// Frees the coroutine's frame, wherever the loop is suspended
+		~GameLoop();
+		/*
+		 * done returns whether the loop has ended, because the game
+		 * is over (won, lost, or quit) or the input was closed.
+		 *
+		 * Returns:
+		 * True once no more lines can be fed.
+		 */
+		bool done() const;
+		/*
+		 * feed runs one line of input through the game, then the next
+		 * prompt if the game is still in progress, and returns once the
+		 * loop needs another line or has ended. The line only has to
+		 * stay valid until feed returns.
+		 *
+		 * Args:
+		 * One line of user input, without the newline. Must not be called once done.
+		 */
+		void feed(std::string_view line);
+		/*
+		 * close tells the loop there is no more input (ex. the player hung up),
+		 * the same as std::getline failing in Game::play. The loop flushes
+		 * the output and ends. Does nothing if the loop has already ended.
+		 */
+		void close();
+};
+
+#endif
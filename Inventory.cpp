@@ -0,0 +1,80 @@
+#include "Inventory.h"
+
+/*
+ * Inventory holds the player's items, and keeps the totals
+ * for weight, calories, and edible items up to date as items
+ * come and go.
+ */
+
+Inventory::Inventory() : weightUnits(0), calorieCount(0), edibleCount(0){}
+
+void Inventory::count(const ItemStore& store, ItemHandle item, int sign){
+	weightUnits += sign * store.weight_units(item);
+	calorieCount += sign * store.calories(item);
+	if (store.calories(item) > 0){
+		edibleCount += sign;
+	}
+}
+
+void Inventory::take(const ItemStore& store, ItemSlots& slots, std::vector<ItemHandle>& from, int slot){
+	count(store, from[slot], 1);
+	slots.move(from, slot, handles);
+}
+
+void Inventory::give(const ItemStore& store, ItemSlots& slots, int slot, std::vector<ItemHandle>& to){
+	count(store, handles[slot], -1);
+	slots.move(handles, slot, to);
+}
+
+void Inventory::remove(const ItemStore& store, ItemSlots& slots, int slot){
+	count(store, handles[slot], -1);
+	slots.remove(handles, slot);
+}
+
+void Inventory::add(const ItemStore& store, ItemSlots& slots, ItemHandle item){
+	count(store, item, 1);
+	slots.place(item, handles);
+}
+
+const std::vector<ItemHandle>& Inventory::items() const{
+	return handles;
+}
+
+int Inventory::size() const{
+	return handles.size();
+}
+
+float Inventory::weight() const{
+	return (float)weightUnits / WEIGHT_UNITS_PER_POUND;
+}
+
+int Inventory::weight_units() const{
+	return weightUnits;
+}
+
+int Inventory::calories() const{
+	return calorieCount;
+}
+
+int Inventory::edible_count() const{
+	return edibleCount;
+}
+
+int Inventory::inedible_count() const{
+	return handles.size() - edibleCount;
+}
+
+// Add everything up from scratch and compare with the running totals
+bool Inventory::matches(const ItemStore& store) const{
+	int expectedWeight = 0;
+	int expectedCalories = 0;
+	int expectedEdible = 0;
+	for (ItemHandle item : handles){
+		expectedWeight += store.weight_units(item);
+		expectedCalories += store.calories(item);
+		if (store.calories(item) > 0){
+			expectedEdible++;
+		}
+	}
+	return expectedWeight == weightUnits && expectedCalories == calorieCount && expectedEdible == edibleCount;
+}
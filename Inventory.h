@@ -0,0 +1,101 @@
+#ifndef __INVENTORY_H__ // INCLUDE GUARD
+#define __INVENTORY_H__
+
+#include <vector>
+#include "Item.h"
+#include "ItemStore.h"
+
+/*
+ * Header file for Inventory.cpp
+ * Inventory is the list of items the player is carrying (as handles
+ * into the world's ItemStore), along with running totals that are
+ * kept up to date on every change: the exact weight (in hundredths of
+ * a pound), the calories of the food carried, and how many of the
+ * items are edible and inedible. Reading a total is O(1), instead of
+ * adding up the items each time.
+ * All changes go through the methods here so the totals can't get
+ * out of step with the items; matches recomputes the totals from
+ * scratch to check that they haven't.
+ */
+
+class Inventory{
+	private:
+		std::vector<ItemHandle> handles; // Items being carried
+		int weightUnits; // Total weight, in hundredths of a pound
+		int calorieCount; // Total calories of the items being carried
+		int edibleCount; // Number of items with calories
+		// Add an item's share of the totals (sign is 1 to add, -1 to take away)
+		void count(const ItemStore& store, ItemHandle item, int sign);
+		// Snapshot restores the handles and recounts the totals
+		friend class Snapshot;
+	public:
+		// Constructor, makes an empty inventory
+		Inventory();
+		/*
+		 * take moves an item from a handle list (ex. a room's items)
+		 * into the inventory.
+		 *
+		 * Args:
+		 * store, the item store
+		 * slots, the game's item slots
+		 * from, the list the item is in
+		 * slot, the item's position in from
+		 */
+		void take(const ItemStore& store, ItemSlots& slots, std::vector<ItemHandle>& from, int slot);
+		/*
+		 * give moves the item at slot out of the inventory to a handle list.
+		 *
+		 * Args:
+		 * store, the item store
+		 * slots, the game's item slots
+		 * slot, the item's position in the inventory
+		 * to, the list to move it to
+		 */
+		void give(const ItemStore& store, ItemSlots& slots, int slot, std::vector<ItemHandle>& to);
+		/*
+		 * remove takes the item at slot out of the inventory without putting
+		 * it anywhere (ex. the Elf ate it).
+		 *
+		 * Args:
+		 * store, the item store
+		 * slots, the game's item slots
+		 * slot, the item's position in the inventory
+		 */
+		void remove(const ItemStore& store, ItemSlots& slots, int slot);
+		/*
+		 * add puts an item that is in no list into the inventory (ex. a bought item).
+		 *
+		 * Args:
+		 * store, the item store
+		 * slots, the game's item slots
+		 * item, the handle of the item to add
+		 */
+		void add(const ItemStore& store, ItemSlots& slots, ItemHandle item);
+		// The handles of the items being carried; slot i is handles()[i]
+		const std::vector<ItemHandle>& items() const;
+		// Number of items being carried
+		int size() const;
+		// Total weight being carried, in pounds
+		float weight() const;
+		// Total weight being carried, in hundredths of a pound
+		int weight_units() const;
+		// Total calories of the items being carried
+		int calories() const;
+		// Number of items being carried that have calories
+		int edible_count() const;
+		// Number of items being carried that have no calories
+		int inedible_count() const;
+		/*
+		 * matches adds up the totals again from the items themselves and
+		 * compares them with the running totals.
+		 *
+		 * Args:
+		 * The item store the inventory's handles refer to.
+		 *
+		 * Returns:
+		 * True if every running total is right.
+		 */
+		bool matches(const ItemStore& store) const;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "Item.h"
+#include "SymbolTable.h"
 #include <string>
 #include <iostream>
 
@@ -15,14 +16,14 @@
 
 // DEFAULT CONSTRUCTOR
 Item::Item(){
-	name = "N/A";
+	nameId = SymbolTable::global().intern("N/A");
 	description = "N/A";
 	calories = 0;
 	weight = 0.0f;
 } 
 
 // PARAMETERIZED CONSTRUCTOR
-Item::Item(std::string name, std::string description, int calories, float weight){
+Item::Item(std::string_view name, std::string_view description, int calories, float weight){
 	// Verify that the inputted values are correct; throw an error if not.
 	if (name.empty()){
 		throw std::invalid_argument("Name of item cannot be empty.");
@@ -46,7 +47,7 @@ Item::Item(std::string name, std::string description, int calories, float weight
 	}
 	
 	// Set values
-	this->name = name;
+	this->nameId = SymbolTable::global().intern(name);
 	this->description = description;
 	this->calories = calories;
 	this->weight = weight;	
@@ -54,7 +55,7 @@ Item::Item(std::string name, std::string description, int calories, float weight
 
 // OVERLOADED STREAM OPERATOR - FUNCTION HEADER CAME FROM CHATGPT
 std::ostream& operator<<(std::ostream& itemString, const Item& item) {
-	itemString << item.name << " (" << item.calories << " calories) - " << item.weight << " lb - " << item.description << std::endl;
+	itemString << SymbolTable::global().name(item.nameId) << " (" << item.calories << " calories) - " << item.weight << " lb - " << item.description << "\n";
 	return itemString;
 }
 
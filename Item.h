@@ -2,13 +2,19 @@
 #define __H_ITEM__
 
 #include <string>
+#include <string_view>
 #include <iostream>
 
 /*
  * Header file of Item.cpp; Item is an object with a name, description,
- * number of calories, and weight,
+ * number of calories, and weight. The name is kept as an ID in the
+ * global SymbolTable.
  * Includes constructors and an overloaded stream operator
  * to format the output of an Item object.
+ * Once an item is put in a world, its fields are kept in the
+ * world's ItemStore, and rooms refer to it by handle.
+ * The description is a view of text owned elsewhere (a string
+ * literal, or the world's TextArena), so it must outlive the item.
  *
  * Author: Breanna Zinky
  * Date: 10/6/2023
@@ -19,7 +25,7 @@
 class Item {
 	public:
 		Item(); // Default constructor
-		Item(std::string name, std::string description, int calories, float weight); // Parameterized constructor
+		Item(std::string_view name, std::string_view description, int calories, float weight); // Parameterized constructor; description must outlive the item
 		
 		/* 
 		 * Overloaded stream operator, to return a string 
@@ -36,14 +42,17 @@ class Item {
 		 */
 		friend std::ostream& operator<<(std::ostream& itemString, const Item& item);
 	private:
-		std::string name;
-		std::string description;
+		int nameId; // ID of the item's name in the global SymbolTable
+		std::string_view description; // Owned by the world's TextArena (or a string literal)
 		int calories;
 		float weight;
-		// Make item a friend of Location and Game so Location
-		// and Game can access Item's private variables, without getters and setters.
+		// Make item a friend of ItemStore, Location, Game, WorldLoader, and Simulator so they
+		// can access Item's private variables, without getters and setters.
+		friend class ItemStore;
 		friend class Location;
 		friend class Game;
+		friend class WorldLoader;
+		friend class Simulator;
 };
 
 #endif
@@ -0,0 +1,86 @@
+#include "ItemStore.h"
+#include "SymbolTable.h"
+#include <cmath>
+
+/*
+ * ItemStore keeps every item's fields in separate arrays, and
+ * ItemSlots moves items between handle lists with swap and pop.
+ */
+
+// Add an item to the store, and its handle to the end of a list
+ItemHandle ItemStore::add(Item item, std::vector<ItemHandle>& list){
+	ItemHandle handle = nameIds.size();
+	nameIds.push_back(item.nameId);
+	calorieCounts.push_back(item.calories);
+	weightUnits.push_back(std::lround(item.weight * WEIGHT_UNITS_PER_POUND));
+	descriptions.push_back(item.description);
+	list.push_back(handle);
+	return handle;
+}
+
+int ItemStore::name_id(ItemHandle item) const{
+	return nameIds[item];
+}
+
+int ItemStore::calories(ItemHandle item) const{
+	return calorieCounts[item];
+}
+
+float ItemStore::weight(ItemHandle item) const{
+	return (float)weightUnits[item] / WEIGHT_UNITS_PER_POUND;
+}
+
+int ItemStore::weight_units(ItemHandle item) const{
+	return weightUnits[item];
+}
+
+std::string_view ItemStore::description(ItemHandle item) const{
+	return descriptions[item];
+}
+
+int ItemStore::size() const{
+	return nameIds.size();
+}
+
+// Print an item in the same format as the Item stream operator
+void ItemStore::print(std::ostream& out, ItemHandle item) const{
+	out << SymbolTable::global().name(nameIds[item]) << " (" << calorieCounts[item] << " calories) - " << weight(item) << " lb - " << descriptions[item] << "\n";
+}
+
+ItemSlots::ItemSlots(){
+}
+
+ItemSlots::ItemSlots(int itemCount){
+	slots.resize(itemCount, -1);
+}
+
+void ItemSlots::unlink(std::vector<ItemHandle>& list, int slot){
+	ItemHandle last = list.back();
+	list[slot] = last;
+	slots[last] = slot;
+	list.pop_back();
+}
+
+// Put an item that's in no list at the end of one
+void ItemSlots::place(ItemHandle item, std::vector<ItemHandle>& to){
+	slots[item] = to.size();
+	to.push_back(item);
+}
+
+// Move an item from one list to the end of another
+void ItemSlots::move(std::vector<ItemHandle>& from, int slot, std::vector<ItemHandle>& to){
+	ItemHandle item = from[slot];
+	unlink(from, slot);
+	place(item, to);
+}
+
+// Take an item out of a list, leaving it in no list
+void ItemSlots::remove(std::vector<ItemHandle>& from, int slot){
+	ItemHandle item = from[slot];
+	unlink(from, slot);
+	slots[item] = -1;
+}
+
+int ItemSlots::slot(ItemHandle item) const{
+	return slots[item];
+}
@@ -0,0 +1,128 @@
+#ifndef __ITEMSTORE_H__ // INCLUDE GUARD
+#define __ITEMSTORE_H__
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Item.h"
+#include "CowArray.h"
+
+/*
+ * Header file for ItemStore.cpp
+ * ItemStore holds every item in a world, one field per array
+ * (structure of arrays). The fields read when searching, taking,
+ * and giving items (name, calories, weight) sit in their own packed
+ * arrays, and the descriptions, which are only read when printing,
+ * are kept apart from them (as views of the world's text). An item is referred to by its handle,
+ * its index in the arrays, so rooms and the player's inventory are
+ * just lists of handles.
+ * The store only holds what never changes about an item, so one store
+ * is shared by every game played in a world (see WorldDefinition.h).
+ * Where each item is during a game is kept by the game's ItemSlots:
+ * each item's slot, the position it sits at in the handle list holding
+ * it, so it can be removed from that list by moving the last handle
+ * into its place (swap and pop). Moving an item between lists is a few
+ * integer writes, and the slots can be copied safely since they hold
+ * no pointers.
+ * The arrays are CowArrays, so copies of a World share them, and copies
+ * of a game's ItemSlots only copy the parts holding the slots they change.
+ */
+
+// Index of an item in an ItemStore
+typedef int ItemHandle;
+
+// Weights are kept as whole hundredths of a pound, so adding and
+// subtracting them is exact (a float running total drifts)
+const int WEIGHT_UNITS_PER_POUND = 100;
+
+// Items per leaf of the item arrays; the fields are small, so the leaves can be bigger than a CowArray's default
+const int ITEM_LEAF_SIZE = 64;
+
+class ItemStore{
+	private:
+		// Hot fields, read on every search
+		CowArray<int, ITEM_LEAF_SIZE> nameIds; // ID of each item's name in the global SymbolTable
+		CowArray<int, ITEM_LEAF_SIZE> calorieCounts;
+		CowArray<int, ITEM_LEAF_SIZE> weightUnits; // Hundredths of a pound
+		// Cold fields, only read when printing
+		CowArray<std::string_view, ITEM_LEAF_SIZE> descriptions;
+	public:
+		/*
+		 * add puts a new item in the store and appends its handle to a list.
+		 *
+		 * Args:
+		 * item, the item to add
+		 * list, the handle list the item starts in (ex. a room's items)
+		 *
+		 * Returns:
+		 * The new item's handle.
+		 */
+		ItemHandle add(Item item, std::vector<ItemHandle>& list);
+		// ID of the item's name in the global SymbolTable
+		int name_id(ItemHandle item) const;
+		int calories(ItemHandle item) const;
+		float weight(ItemHandle item) const;
+		// Weight in hundredths of a pound
+		int weight_units(ItemHandle item) const;
+		std::string_view description(ItemHandle item) const;
+		// Number of items in the store
+		int size() const;
+		/*
+		 * print writes an item the same way the Item stream operator does:
+		 * its name, calories, weight, and description on one line.
+		 *
+		 * Args:
+		 * out, the output stream to write to
+		 * item, the handle of the item to print
+		 */
+		void print(std::ostream& out, ItemHandle item) const;
+};
+
+class ItemSlots{
+	private:
+		CowArray<int, ITEM_LEAF_SIZE> slots; // Position of each item in the handle list holding it, or -1 if none
+		// Remove the handle at slot from the list by moving the last handle into its place
+		void unlink(std::vector<ItemHandle>& list, int slot);
+		// Snapshot puts every handle back in its slot, and SharedWorld unshares the slots
+		friend class Snapshot;
+		friend class SharedWorld;
+	public:
+		// Constructor, for no items
+		ItemSlots();
+		// Constructor, for a store of itemCount items that are all in no list yet
+		ItemSlots(int itemCount);
+		/*
+		 * place appends an item that is in no list to a handle list
+		 * (ex. the items a room starts with, or a bought item).
+		 *
+		 * Args:
+		 * item, the item to place
+		 * to, the list to put it in
+		 */
+		void place(ItemHandle item, std::vector<ItemHandle>& to);
+		/*
+		 * move takes the item at slot out of one handle list and appends it
+		 * to another. The last handle in from takes the moved item's place,
+		 * so the order of from changes.
+		 *
+		 * Args:
+		 * from, the list the item is in
+		 * slot, the item's position in from
+		 * to, the list to move the item to
+		 */
+		void move(std::vector<ItemHandle>& from, int slot, std::vector<ItemHandle>& to);
+		/*
+		 * remove takes the item at slot out of a handle list without putting it
+		 * anywhere else (ex. the Elf ate it). The item stays in the store.
+		 *
+		 * Args:
+		 * from, the list the item is in
+		 * slot, the item's position in from
+		 */
+		void remove(std::vector<ItemHandle>& from, int slot);
+		// The item's position in the handle list holding it, or -1 if it's in none
+		int slot(ItemHandle item) const;
+};
+
+#endif
@@ -0,0 +1,244 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring> // For std::strerror
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/resource.h> // For setrlimit
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "Game.h"
+
+/*
+ * Load generator for the GVZork server (Server.cpp).
+ * Connects many sessions to the server at once, waits for every one
+ * to get its welcome, then has them all play at the same time: each
+ * session sends a command, waits for the reply to end with the prompt,
+ * and sends the next, until it has sent its share. The time from
+ * sending a command to getting the whole reply back is its latency,
+ * and the client prints the median (p50), p99, p99.9, and worst latency
+ * over every command, plus the commands per second over all sessions.
+ * It runs on one thread with one epoll instance, so it is best run on
+ * a core the server isn't using.
+ * Session n starts at line n of the script and loops around it, so
+ * the server isn't sent the same command by every session at once.
+ * The default script only looks, talks, and moves, so no game ends
+ * early; a script that ends games closes those sessions early.
+ *
+ * Usage:
+ * loadclient [--socket <path>] [--sessions N] [--commands N] [--script <file>]
+ *  --socket <path>  the server's socket (default gvzork.sock)
+ *  --sessions N     number of sessions connected at once (default 1000)
+ *  --commands N     commands each session sends (default 20)
+ *  --script <file>  commands to send, one per line, instead of the default script
+ */
+
+// Commands each session goes through, starting at a different one per session
+static const std::vector<std::string> DEFAULT_SCRIPT = {"look", "go North", "talk Professor", "inventory", "go South",
+	"meet Employee", "go East", "look", "go West", "talk Elf", "help", "go North"};
+
+// One connection to the server
+struct Client{
+	int fd = -1;
+	std::string tail; // The end of what has been received this turn, enough to spot the prompt
+	int sent = 0; // Commands sent so far
+	std::size_t next = 0; // Line of the script to send next
+	bool welcomed = false; // Whether the welcome (and first prompt) has been received
+	std::chrono::steady_clock::time_point sentAt; // When the command being waited on was sent
+};
+
+// Read what has arrived; returns true once the reply so far ends with the prompt
+static bool receive(Client& client, bool& closed){
+	char buffer[4096];
+	ssize_t received;
+	while ((received = ::recv(client.fd, buffer, sizeof(buffer), 0)) > 0){
+		client.tail.append(buffer, received);
+		if (client.tail.size() > Game::PROMPT.size()){
+			client.tail.erase(0, client.tail.size() - Game::PROMPT.size());
+		}
+	}
+	closed = received == 0 || (errno != EAGAIN && errno != EINTR);
+	return client.tail == Game::PROMPT;
+}
+
+// Send the client's next command; the commands are short, so the socket always takes all of one
+static void send_command(Client& client, const std::vector<std::string>& script){
+	std::string line = script[client.next] + "\n";
+	client.next = (client.next + 1) % script.size();
+	client.tail.clear();
+	client.sentAt = std::chrono::steady_clock::now();
+	if (::send(client.fd, line.data(), line.size(), MSG_NOSIGNAL) != (ssize_t)line.size()){
+		throw std::invalid_argument(std::string("Could not send a command: ") + std::strerror(errno));
+	}
+	client.sent++;
+}
+
+// Latency at the given fraction of the way through the sorted latencies
+static double percentile(const std::vector<double>& sorted, double fraction){
+	return sorted[std::min(sorted.size() - 1, (std::size_t)(fraction * sorted.size()))];
+}
+
+int main(int argc, char** argv){
+	std::string socketPath = "gvzork.sock";
+	int sessions = 1000;
+	int commands = 20;
+	std::string scriptPath;
+	try {
+		for (int a = 1; a < argc; a++){
+			std::string arg = argv[a];
+			if (a + 1 >= argc){
+				throw std::invalid_argument("Missing value for " + arg);
+			}
+			std::string value = argv[++a];
+			if (arg == "--socket"){
+				socketPath = value;
+			} else if (arg == "--sessions"){
+				sessions = std::stoi(value);
+			} else if (arg == "--commands"){
+				commands = std::stoi(value);
+			} else if (arg == "--script"){
+				scriptPath = value;
+			} else {
+				throw std::invalid_argument("Unknown option " + arg);
+			}
+		}
+		if (sessions < 1 || commands < 1){
+			throw std::invalid_argument("--sessions and --commands must be at least 1");
+		}
+	} catch (const std::exception& e){
+		std::cerr << e.what() << "\nUsage: " << argv[0] << " [--socket <path>] [--sessions N] [--commands N] [--script <file>]" << std::endl;
+		return 2;
+	}
+
+	std::vector<std::string> script = DEFAULT_SCRIPT;
+	if (!scriptPath.empty()){
+		std::ifstream file(scriptPath);
+		if (!file){
+			std::cerr << "Could not open script: " << scriptPath << std::endl;
+			return 1;
+		}
+		script.clear();
+		std::string line;
+		while (std::getline(file, line)){
+			script.push_back(line);
+		}
+		if (script.empty()){
+			std::cerr << "Script is empty: " << scriptPath << std::endl;
+			return 1;
+		}
+	}
+
+	// Every session takes a file descriptor, so raise the limit as far as it goes
+	rlimit files;
+	if (getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur < files.rlim_max){
+		files.rlim_cur = files.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &files);
+	}
+
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (socketPath.size() >= sizeof(address.sun_path)){
+		std::cerr << "Socket path is too long: " << socketPath << std::endl;
+		return 1;
+	}
+	socketPath.copy(address.sun_path, socketPath.size());
+
+	std::vector<Client> clients(sessions);
+	std::vector<double> latencies; // In microseconds
+	latencies.reserve((std::size_t)sessions * commands);
+	int gamesEnded = 0;
+	double seconds = 0;
+	try {
+		int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+		if (epoll < 0){
+			throw std::invalid_argument(std::string("Could not set up epoll: ") + std::strerror(errno));
+		}
+		// Connect every session. The connects block, so a full listen queue just waits for the server to catch up
+		auto connectStart = std::chrono::steady_clock::now();
+		for (int c = 0; c < sessions; c++){
+			Client& client = clients[c];
+			client.fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+			if (client.fd < 0 || ::connect(client.fd, (const sockaddr*)&address, sizeof(address)) < 0){
+				throw std::invalid_argument("Could not connect session " + std::to_string(c) + " to " + socketPath + ": " + std::strerror(errno));
+			}
+			::fcntl(client.fd, F_SETFL, ::fcntl(client.fd, F_GETFL) | O_NONBLOCK);
+			client.next = c % script.size();
+			epoll_event event{};
+			event.events = EPOLLIN;
+			event.data.u32 = c;
+			::epoll_ctl(epoll, EPOLL_CTL_ADD, client.fd, &event);
+		}
+		std::vector<epoll_event> events(1024);
+		// Wait for every welcome before timing anything
+		int welcomed = 0;
+		while (welcomed < sessions){
+			int count = ::epoll_wait(epoll, events.data(), events.size(), -1);
+			for (int e = 0; e < count; e++){
+				Client& client = clients[events[e].data.u32];
+				bool closed;
+				if (receive(client, closed) && !client.welcomed){
+					client.welcomed = true;
+					welcomed++;
+				} else if (closed){
+					throw std::invalid_argument("The server closed a session before welcoming it");
+				}
+			}
+		}
+		std::cout << "Connected " << sessions << " sessions in "
+			<< std::chrono::duration<double>(std::chrono::steady_clock::now() - connectStart).count() << " seconds" << std::endl;
+
+		// Every session sends its first command, then the next one each time a reply comes back
+		auto start = std::chrono::steady_clock::now();
+		for (Client& client : clients){
+			send_command(client, script);
+		}
+		int finished = 0;
+		while (finished < sessions){
+			int count = ::epoll_wait(epoll, events.data(), events.size(), -1);
+			for (int e = 0; e < count; e++){
+				Client& client = clients[events[e].data.u32];
+				if (client.fd < 0){
+					continue;
+				}
+				bool closed;
+				bool replied = receive(client, closed);
+				if (replied){
+					latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - client.sentAt).count());
+				}
+				if (replied && client.sent < commands){
+					send_command(client, script);
+				} else if (replied || closed){
+					gamesEnded += !replied;
+					::close(client.fd);
+					client.fd = -1;
+					finished++;
+				}
+			}
+		}
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		::close(epoll);
+	} catch (const std::invalid_argument& e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	std::cout << "Sessions: " << sessions << "\n"
+		<< "Commands: " << latencies.size() << " in " << seconds << " seconds (" << (seconds > 0 ? latencies.size() / seconds : 0.0) << " commands/second)\n";
+	if (gamesEnded > 0){
+		std::cout << "Sessions closed by the server: " << gamesEnded << "\n";
+	}
+	if (!latencies.empty()){
+		std::cout << "Latency (microseconds): p50 " << percentile(latencies, 0.5) << ", p99 " << percentile(latencies, 0.99)
+			<< ", p99.9 " << percentile(latencies, 0.999) << ", max " << latencies.back() << "\n";
+	}
+	std::cout << std::flush;
+	return 0;
+}
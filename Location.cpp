@@ -1,18 +1,15 @@
 #include "Location.h"
+#include "SymbolTable.h"
 #include <iostream>
 #include <string>
-#include <functional>
 #include <vector>
 
 /*
  * A Location object that has a name,
- * description, attribute representing whether
- * the location has been visited, a vector of NPCs
- * in the room, a vector of Items in the room,
- * and a map of directions and neighboring Locations.
- * Includes functions to add a location to the neighbors map,
- * add an item to the room, add an NPC to the room, get
- * the neighbors, and an overloaded stream operator
+ * description, a vector of NPCs
+ * in the room, and the handles of the Items the room starts with.
+ * Includes functions to add an item to the room,
+ * add an NPC to the room, find NPCs by name, and a function
  * to print out the Location in a specific format.
  *
  * Author: Breanna Zinky
@@ -21,82 +18,87 @@
 
 // Default constructor
 Location::Location(){
-	name = "The Void";
+	nameId = SymbolTable::global().intern("The Void");
 	description = "An empty pitch black void of nothingness...";
-	alreadyVisited = false;
 }
 
 // Parameterized constructor
-Location::Location(std::string name, std::string description){
-	this->name = name;
+Location::Location(std::string_view name, std::string_view description){
+	this->nameId = SymbolTable::global().intern(name);
 	this->description = description;
-	this->alreadyVisited = false;
-}
-
-// Method to add the location into the map with the provided direction string
-void Location::add_location(std::string direction, Location location){
-	// Raise an exception if the string is blank or the key already exists in the map
-	if (direction.empty()){
-		throw std::invalid_argument("Direction string cannot be empty");
-	}
-	if (neighborsMap.count(direction)) { // AI/ChatGPT was used to find the count function to determine if
-					     // direction already exists in neighborsMap as a key
-		throw std::invalid_argument("This direction is already a key in the map.");
-	}
-	// neighborsMap[direction] = location does not work. This is because the [] operator of a map requires the 
-	// value to be default-constructible. Instead, we can use something else here (found through documentation):
-	neighborsMap.insert_or_assign(direction, location);
 }
 
 // Method to add an NPC to the locations vector of NPCs from the back
 void Location::add_npc(NPC npc){
-	locationNPCs.push_back(npc);
+	locationNPCs.push_back(std::move(npc));
+	index_new_npc();
+}
+
+// Make an NPC in place at the back of the location's NPCs, and return it for adding messages
+NPC& Location::emplace_npc(std::string_view name, std::string_view description){
+	locationNPCs.emplace_back(name, description);
+	index_new_npc();
+	return locationNPCs.back();
+}
+
+// Make an item straight in the store, with its handle at the back of the location's items
+ItemHandle Location::emplace_item(ItemStore& store, std::string_view name, std::string_view description, int calories, float weight){
+	return store.add(Item(name, description, calories, weight), locationItems);
 }
 
-// Method to add an item to the locations vector of NPCs from the back
-void Location::add_item(Item item){
-	locationItems.push_back(item);
+// Method to put an item in the store and add its handle to the back of the location's items
+void Location::add_item(Item item, ItemStore& store){
+	store.add(std::move(item), locationItems);
 }
 
-// Method to get the map of neighbors
-std::map<std::string, std::reference_wrapper<Location> > Location::get_neighbors(){
-	return neighborsMap; 
+// Index the NPC just added at the back, or build the index once there are too many to scan
+void Location::index_new_npc(){
+	if (npcIndex.built()){
+		npcIndex.push_back(locationNPCs.back().nameId);
+	} else if (locationNPCs.size() > INDEX_THRESHOLD){
+		std::vector<int> names;
+		for (const NPC& npc : locationNPCs){
+			names.push_back(npc.nameId);
+		}
+		npcIndex.build(names);
+	}
+}
+
+// Look the name up in the index, or scan the NPCs if the room doesn't have one
+int Location::find_npc(int nameId) const{
+	if (npcIndex.built()){
+		return npcIndex.find(nameId);
+	}
+	for (int n = 0; n < static_cast<int>(locationNPCs.size()); n++){
+		if (locationNPCs[n].nameId == nameId){
+			return n;
+		}
+	}
+	return -1;
 }
 
-// Overloaded stream operator to print the location with information like name,
-// description, items, NPCs, and neighbors
-std::ostream& operator<<(std::ostream& locationString, const Location& location){
-	locationString << "\n" << location.name << " - " << location.description << std::endl; // name and desc
-	if (location.locationNPCs.empty()){
-		locationString << "\nYou are alone..." << std::endl;
+// Print the location with information like name, description, items, and NPCs
+void Location::print(std::ostream& locationString, const std::vector<ItemHandle>& items, const ItemStore& store) const{
+	locationString << "\n" << SymbolTable::global().name(nameId) << " - " << description << "\n"; // name and desc
+	if (locationNPCs.empty()){
+		locationString << "\nYou are alone...\n";
 	} else { 
 		locationString << "\nYou see the following NPCs: \n";
 		// List the NPCs from NPC vector	
-		for (int n = 0; n < location.locationNPCs.size(); n++){
-			locationString << " - " << location.locationNPCs.at(n);       
+		for (int n = 0; n < locationNPCs.size(); n++){
+			locationString << " - " << locationNPCs.at(n);       
 		}
 	}
-	if (location.locationItems.empty()){
-		locationString << "\nThere are no items here." << std::endl;
+	if (items.empty()){
+		locationString << "\nThere are no items here.\n";
 	} else {
 		locationString << "\nYou see the following Items: \n";
 		// List the items from item vector
-		for (int i = 0; i < location.locationItems.size(); i++){
-			locationString << " - " << location.locationItems.at(i);
+		for (int i = 0; i < items.size(); i++){
+			locationString << " - ";
+			store.print(locationString, items[i]);
 		}
 	}
-		// List the neighbor locations 
-	locationString << "\nYou can go in the following Directions: ";
-		for (auto j = location.neighborsMap.begin(); j != location.neighborsMap.end(); ++j){
-			// If location hasn't been visited, do not print the name - print unknown.
-			if (!j->second.get().alreadyVisited){
-				locationString << "\n - " << j->first << " - " << "Unknown";
-			} else {
-				locationString << "\n - " << j->first <<  " - " << j->second.get().name << " (Visited) ";
-			}
-		}
-	locationString << std::endl; 
-	return locationString;
 }
 
 
@@ -2,23 +2,35 @@
 #define __LOCATION_H__
 
 #include <vector>
-#include <map>
 #include "Item.h"
+#include "ItemStore.h"
 #include "NPC.h"
-#include <functional> // For reference_wrapper
+#include "NameIndex.h"
 #include <iostream>
 #include <string>
+#include <string_view>
 
 /*
  * Header file for Location.cpp
- * Location is an object with a name, description,
- * attribute to represent if the location has been visited,
- * vector of NPCs in the room, vector of Items in the room,
- * and a map of directions to other neighboring locations.
- * Includes constructors, a method to add a location into the
- * neighbors map, a method to add an NPC to the room, a method
- * to add an item to the room, a method to get the map of neighbors,
- * and an overloaded stream operator to format a Location nicely.
+ * Location is an object with a name (an ID in the global SymbolTable), description,
+ * vector of NPCs in the room, and the handles of the Items the room starts
+ * with (the items themselves are in the world's ItemStore).
+ * A location only holds what never changes while a game is played, so
+ * one is shared by every game in the world (see WorldDefinition.h);
+ * whether it has been visited and the items in it now are kept per game
+ * in the game's WorldState (see WorldState.h).
+ * The description is a view of text owned elsewhere (a string
+ * literal, or the world's TextArena), so it must outlive the location.
+ * The directions to neighboring locations are kept in the
+ * world's WorldGraph, by location index.
+ * Includes constructors, methods to add (or make in place) an NPC in
+ * the room, methods to add (or make in place) an item in the room,
+ * and a method to print
+ * a Location nicely.
+ * The commands find NPCs by name with find_npc. Rooms with more than
+ * INDEX_THRESHOLD NPCs (or items, see WorldState) keep a NameIndex
+ * of them, so a crowded room doesn't have to be scanned; smaller rooms
+ * are scanned from the front, which is faster than hashing for a few names.
  *
  * Author: Breanna Zinky
  * Date: 10/6/2023
@@ -26,32 +38,31 @@
 
 class Location{
 	private:
-		std::string name;
-		std::string description;
-		bool alreadyVisited; // Holds whether or not the location has already been visited
+		int nameId; // ID of the location's name in the global SymbolTable
+		std::string_view description; // Owned by the world's TextArena (or a string literal)
 		std::vector<NPC> locationNPCs; // Vector of NPCs in the location
-		std::vector<Item> locationItems; // Vector of Items in the location
-		// Map that holds directions to neighboring locations. Used references
-		// since the locations are changing, and using just copies won't reflect these changes.
-		// Used reference_wrapper to be able to have a reference in a collection.
-		std::map<std::string, std::reference_wrapper<Location> > neighborsMap;
-		// Friend of Game so Game can access location's private attributes without
-		// getters and setters.
+		std::vector<ItemHandle> locationItems; // Handles of the Items the location starts with, in the world's ItemStore
+		NameIndex npcIndex; // Name -> position in locationNPCs, only built for crowded rooms
+		// Keep the NPC index up to date after adding an NPC, building it once the room gets crowded
+		void index_new_npc();
+		// Friend of Game, WorldGraph, WorldLoader, Simulator, Snapshot, WorldState, WorldDefinition, EventLog, and EventReplayer so they
+		// can access location's private attributes without getters and setters.
 		friend class Game;
+		friend class WorldGraph;
+		friend class WorldLoader;
+		friend class Simulator;
+		friend class Snapshot;
+		friend class WorldState;
+		friend class WorldDefinition;
+		friend class EventLog;
+		friend class EventReplayer;
 	public:
+		// Rooms with more NPCs (or items) than this get a NameIndex for them
+		static const int INDEX_THRESHOLD = 16;
 		// Default constructor
 		Location();
 		// Parameterized constructor
-		Location(std::string name, std::string description);
-		/*
-		 * add_location adds the location into the map with the provided direction string.
-		 * 
-		 * Args:
-		 * A string representing the direction, the key in the map
-		 * A Location object representing the neighboring location
-		 *
-		 */
-		void add_location(std::string direction, Location location);
+		Location(std::string_view name, std::string_view description);
 		/*
 		 * add_npc adds an NPC to the back of the location's vector
 		 * of NPCs in the room
@@ -61,37 +72,68 @@ class Location{
 		 */
 		void add_npc(NPC npc);
 		/*
-		 * add_item adds an Item to the back of the location's
-		 * vector of Items in the room.
+		 * add_item puts an Item in the item store and adds its
+		 * handle to the back of the location's Items.
 		 * 
 		 * Args:
-		 * An Item object to be added
+		 * item, an Item object to be added
+		 * store, the world's item store
 		 */
-		void add_item(Item item);
+		void add_item(Item item, ItemStore& store);
 		/*
-		 * get_neighbors gets the map of directions
-		 * and neighboring locations.
-		 * 
+		 * emplace_npc makes an NPC in place at the back of the location's
+		 * vector of NPCs, instead of making one and copying it in.
+		 * Throws an invalid_argument exception like the NPC constructor.
+		 *
+		 * Args:
+		 * name, the NPC's name
+		 * description, the NPC's description (must outlive the location)
+		 *
 		 * Returns:
-		 * The map of directions and neighboring locations.
-		 */ 
-		std::map<std::string, std::reference_wrapper<Location> > get_neighbors();
+		 * A reference to the new NPC, for adding its messages
+		 * (ex. emplace_npc(...).addMessage(...).addMessage(...)). It is
+		 * only valid until another NPC is added to the location.
+		 */
+		NPC& emplace_npc(std::string_view name, std::string_view description);
 		/*
-		 * Overloaded stream operator to return a string
-		 * representing the Location in a specific format.
-		 * Includes the name and description of the Location,
-		 * a list of the Items and NPCs in the room, and the neighboring
-		 * locations and directions.
-		 * Used ChatGPT to determine how the header of an
-		 * overloaded stream operator should be written.
+		 * emplace_item puts a new item straight into the item store and
+		 * adds its handle to the back of the location's Items.
+		 * Throws an invalid_argument exception like the Item constructor.
+		 *
 		 * Args:
-		 * locationString, a reference to the output stream to be written to
-		 * location, a constant reference to a location object to be outputted
+		 * store, the world's item store
+		 * name, the item's name
+		 * description, the item's description (must outlive the store)
+		 * calories, the item's calories
+		 * weight, the item's weight
 		 *
 		 * Returns:
-		 * A reference to an std::ostream object, the output stream to be written to       
+		 * The new item's handle.
+		 */
+		ItemHandle emplace_item(ItemStore& store, std::string_view name, std::string_view description, int calories, float weight);
+		/*
+		 * find_npc finds an NPC in the location by name.
+		 *
+		 * Args:
+		 * The ID of the name in the global SymbolTable (-1 never matches).
+		 *
+		 * Returns:
+		 * The NPC's position in the location's NPCs, or -1 if there's no NPC with that name.
+		 * If more than one has the name, which one is found is up to the index.
+		 */
+		int find_npc(int nameId) const;
+		/*
+		 * print writes the Location in a specific format.
+		 * Includes the name and description of the Location,
+		 * and a list of the Items and NPCs in the room. The directions
+		 * are printed separately by WorldGraph::print_directions.
+		 *
+		 * Args:
+		 * locationString, a reference to the output stream to be written to
+		 * items, the handles of the items in the room now (ex. from a WorldState)
+		 * store, the item store the handles refer to
 		 */
-		friend std::ostream& operator<<(std::ostream& locationString, const Location& location);
+		void print(std::ostream& locationString, const std::vector<ItemHandle>& items, const ItemStore& store) const;
 };
 
 #endif
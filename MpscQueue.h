@@ -0,0 +1,91 @@
+#ifndef __MPSCQUEUE_H__ // INCLUDE GUARD
+#define __MPSCQUEUE_H__
+
+#include <atomic>
+
+/*
+ * MpscQueue is a lock-free first in, first out queue that any number
+ * of threads can push onto, and one thread pops from (multiple producer,
+ * single consumer). It's intrusive: what's queued derives from MpscNode,
+ * so pushing doesn't allocate, and a node can only be in one queue at a
+ * time. The queue doesn't own its nodes.
+ *
+ * Pushing is one atomic exchange and a store, so producers never wait
+ * for each other or for the consumer. The consumer follows the links
+ * from the oldest node. The queue keeps a stub node of its own, which
+ * is put back at the end whenever the consumer has taken everything
+ * else, so the consumer never has to take the last real node out from
+ * under a producer that is linking a new one after it. (This is
+ * Dmitry Vyukov's intrusive MPSC queue.)
+ *
+ * A push is only linked in once its second step is done, so pop can
+ * briefly see nothing while a push is halfway through. Anything popping
+ * has to come back later (ex. after a wakeup, see ShardRuntime) rather
+ * than take an empty pop to mean nothing will ever come.
+ */
+
+// What a queued type derives from; the link to the node pushed after it
+struct MpscNode{
+	std::atomic<MpscNode*> next{nullptr};
+};
+
+template <typename T>
+class MpscQueue{
+	private:
+		alignas(64) std::atomic<MpscNode*> head; // The node pushed last; producers swap themselves in here
+		alignas(64) MpscNode* tail; // The oldest node, only used by the consumer
+		MpscNode stub; // Stands in at the end whenever the queue has no real nodes left
+		// Push the stub, the same way as a real node
+		void push_stub(){
+			stub.next.store(nullptr, std::memory_order_relaxed);
+			MpscNode* previous = head.exchange(&stub, std::memory_order_seq_cst);
+			previous->next.store(&stub, std::memory_order_release);
+		}
+	public:
+		MpscQueue() : head(&stub), tail(&stub){
+		}
+		MpscQueue(const MpscQueue&) = delete;
+		MpscQueue& operator=(const MpscQueue&) = delete;
+		// Add a node at the end. Any thread can push
+		void push(T* item){
+			MpscNode* node = item;
+			node->next.store(nullptr, std::memory_order_relaxed);
+			MpscNode* previous = head.exchange(node, std::memory_order_seq_cst);
+			previous->next.store(node, std::memory_order_release);
+		}
+		// Take the oldest node off, or nullptr if there is none (or it's still being pushed). Only the consumer can pop
+		T* pop(){
+			MpscNode* oldest = tail;
+			MpscNode* next = oldest->next.load(std::memory_order_acquire);
+			if (oldest == &stub){
+				if (next == nullptr){
+					return nullptr;
+				}
+				tail = next;
+				oldest = next;
+				next = next->next.load(std::memory_order_acquire);
+			}
+			if (next != nullptr){
+				tail = next;
+				return static_cast<T*>(oldest);
+			}
+			// oldest looks like the last node. If another push has started after it, wait for that one to link
+			if (oldest != head.load(std::memory_order_seq_cst)){
+				return nullptr;
+			}
+			// Put the stub behind it, so oldest can be taken without leaving the queue empty of nodes
+			push_stub();
+			next = oldest->next.load(std::memory_order_acquire);
+			if (next != nullptr){
+				tail = next;
+				return static_cast<T*>(oldest);
+			}
+			return nullptr;
+		}
+		// Whether every push that has finished has been popped. Only the consumer can check
+		bool empty() const{
+			return tail == &stub && head.load(std::memory_order_seq_cst) == &stub;
+		}
+};
+
+#endif
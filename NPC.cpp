@@ -1,20 +1,19 @@
 #include "NPC.h"
+#include "SymbolTable.h"
 #include <iostream>
 #include <string>
 #include <vector>
 
 // Default constructor
 NPC::NPC(){
-	name = "Unnamed";
+	nameId = SymbolTable::global().intern("Unnamed");
 	description = "They are a mystery...";
-	messageNum = 0;
-	robbed = false;
 	messages.push_back("Where am I? Who am I? What am I?\n");
 	messages.push_back("The unnamed NPC gazes confusedly into the distance.\n");
 }
 
 // Parameterized constructor
-NPC::NPC(std::string name, std::string description){
+NPC::NPC(std::string_view name, std::string_view description){
 	// Verify that name and description aren't empty
 	if (name.empty()){
 		throw std::invalid_argument("NPC name cannot be empty.");
@@ -24,15 +23,18 @@ NPC::NPC(std::string name, std::string description){
 	}
 
 	// Set name and description
-	this->name = name;
+	this->nameId = SymbolTable::global().intern(name);
 	this->description = description;
-	messageNum = 0;
-	robbed = false;
 }
 
 // Function to get current message and increase message count by 1 (or reset to 0)
-std::string NPC::getCurrentMessage(){
-	std::string currentMessage = messages.at(messageNum); // Get the message from the current index
+std::string_view NPC::getCurrentMessage(int& messageNum) const{
+	// Loaded worlds can't have an NPC without messages, but one built in code can
+	if (messages.empty()){
+		messageNum = 0;
+		return "...";
+	}
+	std::string_view currentMessage = messages.at(messageNum); // Get the message from the current index
 	// If the current message is not the last in the vector, increase it to the next, otherwise reset it back to 0.
 	if (messageNum < (messages.size() - 1)){
 	messageNum++;
@@ -41,12 +43,13 @@ std::string NPC::getCurrentMessage(){
 }
 
 // Method to add message to NPC's message vector
-void NPC::addMessage(std::string message){
+NPC& NPC::addMessage(std::string_view message){
 	messages.push_back(message);
+	return *this;
 }
 
 // Overloaded stream operator to return the name of the NPC. Used ChatGPT to help with how this header should be written.
 std::ostream& operator<<(std::ostream& NPCString, const NPC& npc){
-	NPCString << npc.name << "\n";
+	NPCString << SymbolTable::global().name(npc.nameId) << "\n";
 	return NPCString;
 }
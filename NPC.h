@@ -4,11 +4,18 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 
 /*
  * Header file of NPC.cpp, an NPC object
- * that has a name, description, message number,
- * vector of messages, and robbed attribute.
+ * that has a name, description, and vector of messages.
+ * What changes about an NPC while a game is played (the message
+ * they're on, and whether they've been robbed) is kept per game,
+ * in the game's WorldState (see WorldState.h), so one NPC can be
+ * shared by every game played in a world.
+ * The name is kept as an ID in the global SymbolTable. The
+ * description and messages are views of text owned elsewhere (string
+ * literals, or the world's TextArena), so they must outlive the NPC.
  * Includes constructors, functions to get the
  * current message from the NPC, add a message to
  * the NPC's messages, and an overloaded stream operator
@@ -21,37 +28,46 @@
 
 class NPC {
 	private:
-		std::string name;
-		std::string description;
-		int messageNum; // Index for what message the NPC is on
-		std::vector<std::string> messages; // Vector of all of the NPC's messages
-		bool robbed; // Extra variable to store if a NPC has been stolen from yet or not (can only steal from each NPC once).
-			     // This is used for the added "steal" command!
-		// Making NPC a friend of Location and Game so they can access NPC's private variables
+		int nameId; // ID of the NPC's name in the global SymbolTable
+		std::string_view description; // Owned by the world's TextArena (or a string literal)
+		std::vector<std::string_view> messages; // Vector of all of the NPC's messages, owned like the description
+		// Making NPC a friend of Location, Game, WorldLoader, Simulator, Snapshot, and EventLog so they can access NPC's private variables
 		// without getters and setters.
 		friend class Location;
 		friend class Game;
+		friend class WorldLoader;
+		friend class Simulator;
+		friend class Snapshot;
+		friend class EventLog;
 	public:
 		NPC(); // Default constructor
-		NPC(std::string name, std::string description);// Parameterized constructor					       
+		NPC(std::string_view name, std::string_view description);// Parameterized constructor; description must outlive the NPC
 		/*
 		 * getCurrentMessage() returns the current message from the NPC's
 		 * messages vector and updates the message number,
 		 * allowing you to talk to the NPC and cycle through their messages. 
+		 * Args:
+		 * The index of the message the NPC is on, kept by the game;
+		 * it's moved on to the next message.
+		 *
 		 * Returns:
-		 * A string representing the current message to be displayed.
+		 * A view of the current message to be displayed, so talking
+		 * to an NPC doesn't copy the message ("..." if the NPC has
+		 * no messages).
 		 */
-		std::string getCurrentMessage();
+		std::string_view getCurrentMessage(int& messageNum) const;
 		/*
 		 * addMessage adds a message to NPC's message vector 
 		 * from the back.
 		 * Args:
 		 * A string representing the message to be added to the NPC's
-		 * dialogues.
-		 *
+		 * dialogues. It must outlive the NPC (ex. text in a TextArena).
 		 *
+		 * Returns:
+		 * A reference to this NPC, so messages can be added one after
+		 * another (ex. npc.addMessage("Hi").addMessage("Bye")).
 		 */
-		void addMessage(std::string message);
+		NPC& addMessage(std::string_view message);
 		/* 
 		 * Overloaded stream operator to return a string
 		 * representing the NPC in a specific format.
@@ -0,0 +1,163 @@
+#include "NameIndex.h"
+#include <cstdint>
+
+/*
+ * NameIndex is an open-addressing hash table from name IDs
+ * to slots in a list, with linear probing and backward-shift
+ * deletion (so there are no tombstones to clean up), and a
+ * doubly linked chain through the slots that share a name.
+ */
+
+// Size of the table when the index is first built
+static const int FIRST_TABLE_SIZE = 16;
+
+// Constructor, makes an empty index that hasn't been built
+NameIndex::NameIndex() : entryCount(0){
+}
+
+// Fibonacci hashing: multiply by 2^32 / golden ratio and keep the top bits
+int NameIndex::home(int nameId) const{
+	std::uint32_t hash = static_cast<std::uint32_t>(nameId) * 2654435769u;
+	return static_cast<int>((static_cast<std::uint64_t>(hash) * table.size()) >> 32);
+}
+
+// Walk the name's probe sequence until its entry or an empty slot
+int NameIndex::position(int nameId) const{
+	int mask = table.size() - 1;
+	for (int p = home(nameId); table[p].nameId != EMPTY; p = (p + 1) & mask){
+		if (table[p].nameId == nameId){
+			return p;
+		}
+	}
+	return -1;
+}
+
+// Put a new entry in the first free slot of its probe sequence
+void NameIndex::insert(int nameId, int first){
+	if (2 * (entryCount + 1) > static_cast<int>(table.size())){
+		grow();
+	}
+	int mask = table.size() - 1;
+	int p = home(nameId);
+	while (table[p].nameId != EMPTY){
+		p = (p + 1) & mask;
+	}
+	table[p] = Entry{nameId, first};
+	entryCount++;
+}
+
+// Remove an entry, then shift later entries of the cluster back into the gap,
+// so every entry can still be reached from its home without crossing an empty slot
+void NameIndex::erase(int gap){
+	int mask = table.size() - 1;
+	for (int p = (gap + 1) & mask; table[p].nameId != EMPTY; p = (p + 1) & mask){
+		// The entry at p can move into the gap if its home isn't between the gap and p (cyclically)
+		int distanceFromHome = (p - home(table[p].nameId)) & mask;
+		int distanceFromGap = (p - gap) & mask;
+		if (distanceFromHome >= distanceFromGap){
+			table[gap] = table[p];
+			gap = p;
+		}
+	}
+	table[gap].nameId = EMPTY;
+	entryCount--;
+}
+
+// Double the table and put every entry back in
+void NameIndex::grow(){
+	std::vector<Entry> old;
+	old.swap(table);
+	table.assign(old.size() * 2, Entry{EMPTY, 0});
+	entryCount = 0;
+	for (const Entry& entry : old){
+		if (entry.nameId != EMPTY){
+			insert(entry.nameId, entry.first);
+		}
+	}
+}
+
+// Take a slot out of its name's chain, and the name out of the table if it was the last one
+void NameIndex::unlink(int slot){
+	int next = nextSame[slot];
+	int previous = previousSame[slot];
+	if (previous >= 0){
+		nextSame[previous] = next;
+	} else {
+		int p = position(names[slot]);
+		if (next >= 0){
+			table[p].first = next;
+		} else {
+			erase(p);
+		}
+	}
+	if (next >= 0){
+		previousSame[next] = previous;
+	}
+}
+
+// Index a whole list from scratch
+void NameIndex::build(const std::vector<int>& nameIds){
+	int size = FIRST_TABLE_SIZE;
+	while (size < 2 * static_cast<int>(nameIds.size())){
+		size *= 2;
+	}
+	table.assign(size, Entry{EMPTY, 0});
+	entryCount = 0;
+	names.clear();
+	nextSame.clear();
+	previousSame.clear();
+	for (int nameId : nameIds){
+		push_back(nameId);
+	}
+}
+
+bool NameIndex::built() const{
+	return !table.empty();
+}
+
+// The new slot goes at the front of its name's chain
+void NameIndex::push_back(int nameId){
+	int slot = names.size();
+	names.push_back(nameId);
+	nextSame.push_back(-1);
+	previousSame.push_back(-1);
+	int p = position(nameId);
+	if (p < 0){
+		insert(nameId, slot);
+	} else {
+		nextSame[slot] = table[p].first;
+		previousSame[table[p].first] = slot;
+		table[p].first = slot;
+	}
+}
+
+// Unlink the slot, then move the last slot into its place and fix the links that pointed at it
+void NameIndex::swap_remove(int slot){
+	unlink(slot);
+	int last = names.size() - 1;
+	if (slot != last){
+		names[slot] = names[last];
+		nextSame[slot] = nextSame[last];
+		previousSame[slot] = previousSame[last];
+		if (previousSame[slot] >= 0){
+			nextSame[previousSame[slot]] = slot;
+		} else {
+			table[position(names[slot])].first = slot;
+		}
+		if (nextSame[slot] >= 0){
+			previousSame[nextSame[slot]] = slot;
+		}
+	}
+	names.pop_back();
+	nextSame.pop_back();
+	previousSame.pop_back();
+}
+
+// Look up the name's entry
+int NameIndex::find(int nameId) const{
+	if (table.empty() || nameId < 0){
+		return -1;
+	}
+	int p = position(nameId);
+	return (p < 0) ? -1 : table[p].first;
+}
@@ -0,0 +1,87 @@
+#ifndef __NAMEINDEX_H__ // INCLUDE GUARD
+#define __NAMEINDEX_H__
+
+#include <vector>
+
+/*
+ * Header file for NameIndex.cpp
+ * A NameIndex finds things in a list by name, for a Location's NPCs
+ * and items, so the commands don't have to scan the whole room.
+ * It mirrors the list: the owner makes the same push_back and
+ * swap_remove calls on the index as on the list, with the name ID
+ * (in the global SymbolTable) of what's in each slot.
+ *
+ * It is a hash table with open addressing (linear probing) from each
+ * distinct name to one slot holding it. Names can repeat, so the slots
+ * holding the same name are linked together in a chain, and removing
+ * any slot (even one in the middle of a chain) is constant time.
+ *
+ * Lists that are only ever short don't need an index: one stays empty
+ * (and takes no memory) until build is called.
+ */
+
+class NameIndex{
+	private:
+		// One slot of the table; nameId is EMPTY if the slot is unused
+		struct Entry{
+			int nameId;
+			int first; // A slot of the list holding the name, the start of its chain
+		};
+		static const int EMPTY = -1;
+		std::vector<Entry> table; // Size is a power of two, at most half full
+		int entryCount; // Number of distinct names in the table
+		std::vector<int> names; // List slot -> name ID
+		std::vector<int> nextSame; // List slot -> next slot with the same name, or -1
+		std::vector<int> previousSame; // List slot -> previous slot with the same name, or -1
+		// Where a name starts probing from
+		int home(int nameId) const;
+		// Position of the name's entry in the table, or -1
+		int position(int nameId) const;
+		// Add an entry for a name that isn't in the table, growing the table first if needed
+		void insert(int nameId, int first);
+		// Remove the entry at a position of the table
+		void erase(int position);
+		// Make the table twice as big and put the entries back in
+		void grow();
+		// Take a slot out of its name's chain
+		void unlink(int slot);
+	public:
+		// Constructor, makes an empty index
+		NameIndex();
+		/*
+		 * build throws away the index and indexes the given list from scratch.
+		 *
+		 * Args:
+		 * The name ID of each slot of the list.
+		 */
+		void build(const std::vector<int>& nameIds);
+		// Whether build was called, so the index has to be kept up to date
+		bool built() const;
+		/*
+		 * push_back records a name added to the back of the list.
+		 *
+		 * Args:
+		 * The name's ID in the global SymbolTable.
+		 */
+		void push_back(int nameId);
+		/*
+		 * swap_remove records a slot removed from the list by moving
+		 * the list's last element into it (see ItemStore::move).
+		 *
+		 * Args:
+		 * The slot removed.
+		 */
+		void swap_remove(int slot);
+		/*
+		 * find looks up a name.
+		 *
+		 * Args:
+		 * The name's ID (-1, for a name that was never interned, never matches).
+		 *
+		 * Returns:
+		 * A slot of the list holding the name, or -1 if it isn't in the list.
+		 */
+		int find(int nameId) const;
+};
+
+#endif
@@ -0,0 +1,208 @@
+#include "NameTrie.h"
+#include <algorithm>
+
+/*
+ * NameTrie is a trie of folded names, stored as one vector of
+ * nodes linked by first child and next sibling, with searches
+ * for exact, prefix, and one-edit matches.
+ */
+
+// Constructor, makes the root
+NameTrie::NameTrie(){
+	nodes.push_back(Node{'\0', -1, -1, -1, 0});
+}
+
+// Lower case ASCII letters, single spaces, no spaces at the ends
+void NameTrie::fold(std::string_view text, std::string& folded){
+	folded.clear();
+	bool space = false; // A space is owed before the next character
+	for (char c : text){
+		if (c == ' ' || c == '\t'){
+			space = !folded.empty();
+			continue;
+		}
+		if (space){
+			folded += ' ';
+			space = false;
+		}
+		folded += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+}
+
+int NameTrie::child(int node, char label) const{
+	for (int c = nodes[node].firstChild; c >= 0; c = nodes[c].nextSibling){
+		if (nodes[c].label == label){
+			return c;
+		}
+	}
+	return -1;
+}
+
+// Walk down the folded name, making nodes as needed, and add the ID at the end
+void NameTrie::insert(std::string_view name, int id){
+	std::string folded;
+	fold(name, folded);
+	int node = 0;
+	nodes[0].count++;
+	for (char c : folded){
+		int next = child(node, c);
+		if (next < 0){
+			next = nodes.size();
+			nodes.push_back(Node{c, -1, nodes[node].firstChild, -1, 0});
+			nodes[node].firstChild = next;
+		}
+		node = next;
+		nodes[node].count++;
+	}
+	if (id >= static_cast<int>(nextId.size())){
+		nextId.resize(id + 1, -1);
+	}
+	nextId[id] = nodes[node].firstId;
+	nodes[node].firstId = id;
+}
+
+// Add each ID ending at the node that isn't in the list yet
+bool NameTrie::add_ids(int node, std::vector<int>& ids, int limit) const{
+	for (int id = nodes[node].firstId; id >= 0; id = nextId[id]){
+		if (std::find(ids.begin(), ids.end(), id) != ids.end()){
+			continue;
+		}
+		if (static_cast<int>(ids.size()) >= limit){
+			return false;
+		}
+		ids.push_back(id);
+	}
+	return true;
+}
+
+bool NameTrie::add_subtree(int node, std::vector<int>& ids, int limit) const{
+	if (!add_ids(node, ids, limit)){
+		return false;
+	}
+	for (int c = nodes[node].firstChild; c >= 0; c = nodes[c].nextSibling){
+		if (!add_subtree(c, ids, limit)){
+			return false;
+		}
+	}
+	return true;
+}
+
+// Match text[i...] below the node, allowing one edit if none has been used yet.
+// Once the edit is used, the rest has to match exactly, so each branch is a single walk.
+bool NameTrie::add_typos(int node, const std::string& text, int i, bool edited, std::vector<int>& ids, int limit) const{
+	int length = text.size();
+	if (i == length){
+		if (edited){
+			return add_ids(node, ids, limit);
+		}
+		// The name has one more character at the end
+		for (int c = nodes[node].firstChild; c >= 0; c = nodes[c].nextSibling){
+			if (!add_ids(c, ids, limit)){
+				return false;
+			}
+		}
+		return true;
+	}
+	int next = child(node, text[i]);
+	if (next >= 0 && !add_typos(next, text, i + 1, edited, ids, limit)){
+		return false;
+	}
+	if (edited){
+		return true;
+	}
+	// The text has an extra character
+	if (!add_typos(node, text, i + 1, true, ids, limit)){
+		return false;
+	}
+	for (int c = nodes[node].firstChild; c >= 0; c = nodes[c].nextSibling){
+		// The text has the wrong character here
+		if (nodes[c].label != text[i] && !add_typos(c, text, i + 1, true, ids, limit)){
+			return false;
+		}
+		// The text is missing this character
+		if (!add_typos(c, text, i, true, ids, limit)){
+			return false;
+		}
+	}
+	// The text has two characters swapped
+	if (i + 1 < length && text[i] != text[i + 1]){
+		int swapped = child(node, text[i + 1]);
+		if (swapped >= 0){
+			swapped = child(swapped, text[i]);
+			if (swapped >= 0 && !add_typos(swapped, text, i + 2, true, ids, limit)){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Fold the text, then search for it
+bool NameTrie::find(std::string_view text, Match kind, std::vector<int>& ids, int limit) const{
+	thread_local std::string folded; // Reused, so searching doesn't allocate
+	fold(text, folded);
+	if (folded.empty()){
+		return true;
+	}
+	if (kind == TYPO){
+		if (static_cast<int>(folded.size()) < MIN_TYPO_LENGTH){
+			return true;
+		}
+		return add_typos(0, folded, 0, false, ids, limit);
+	}
+	int node = 0;
+	for (char c : folded){
+		node = child(node, c);
+		if (node < 0){
+			return true;
+		}
+	}
+	if (kind == EXACT){
+		return add_ids(node, ids, limit);
+	}
+	if (nodes[node].count > limit){
+		return false; // Too many to be worth listing
+	}
+	return add_subtree(node, ids, limit);
+}
+
+// Whether two folded names are one edit apart: past the characters they start and end with
+// in common, what's left is one character in one of them, one in each, or two swapped
+static bool one_edit(const std::string& a, const std::string& b){
+	std::size_t first = 0;
+	while (first < a.size() && first < b.size() && a[first] == b[first]){
+		first++;
+	}
+	std::size_t endA = a.size();
+	std::size_t endB = b.size();
+	while (endA > first && endB > first && a[endA - 1] == b[endB - 1]){
+		endA--;
+		endB--;
+	}
+	std::size_t restA = endA - first;
+	std::size_t restB = endB - first;
+	if (restA + restB == 1 || (restA == 1 && restB == 1)){
+		return true;
+	}
+	return restA == 2 && restB == 2 && a[first] == b[first + 1] && a[first + 1] == b[first];
+}
+
+// Fold both, then compare them the way find walks the trie
+bool NameTrie::matches(std::string_view name, std::string_view text, Match kind){
+	thread_local std::string foldedName; // Reused, so matching doesn't allocate
+	thread_local std::string foldedText;
+	fold(name, foldedName);
+	fold(text, foldedText);
+	if (foldedText.empty()){
+		return false;
+	}
+	switch (kind){
+		case EXACT:
+			return foldedName == foldedText;
+		case PREFIX:
+			return foldedName.compare(0, foldedText.size(), foldedText) == 0;
+		case TYPO:
+			return static_cast<int>(foldedText.size()) >= MIN_TYPO_LENGTH && one_edit(foldedName, foldedText);
+	}
+	return false;
+}
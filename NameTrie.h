@@ -0,0 +1,105 @@
+#ifndef __NAMETRIE_H__ // INCLUDE GUARD
+#define __NAMETRIE_H__
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Header file for NameTrie.cpp
+ * A NameTrie finds names that loosely match what the player typed,
+ * so "take subway sub", "take subw", and "take Subwya sub" all find
+ * "Subway sub". Names are stored folded: lower case, with runs of
+ * spaces made into one space and none at the ends, so capitalization
+ * and spacing never matter. Each name has an integer ID (ex. its ID in
+ * the SymbolTable), and names that fold the same share a node.
+ *
+ * The trie is kept compact: one node per character, in a single vector,
+ * with each node pointing at its first child and its next sibling.
+ * Finding matches walks the trie along the text, so it takes time in
+ * proportion to the length of the text (and, for typos, the number of
+ * letters that can follow each prefix), never the number of names.
+ *
+ * Kinds of match:
+ *  EXACT   the folded name is the folded text
+ *  PREFIX  the folded name starts with the folded text
+ *  TYPO    the folded name is one edit away from the folded text: one
+ *          letter added, missing, or changed, or two letters swapped.
+ *          Only texts of at least MIN_TYPO_LENGTH letters, since every
+ *          short word is one edit away from lots of names.
+ */
+
+class NameTrie{
+	private:
+		struct Node{
+			char label; // The character on the edge into this node
+			int firstChild; // -1 if none
+			int nextSibling; // -1 if none
+			int firstId; // First ID of the names ending here, or -1; the rest are chained through nextId
+			int count; // Number of names ending at or below this node
+		};
+		std::vector<Node> nodes; // nodes[0] is the root (the empty prefix)
+		std::vector<int> nextId; // ID -> next ID whose name folds the same, or -1
+		// The child of a node along a character, or -1
+		int child(int node, char label) const;
+		// Add the IDs of the names ending at a node; false once there are more than limit
+		bool add_ids(int node, std::vector<int>& ids, int limit) const;
+		// Add the IDs of every name at or below a node
+		bool add_subtree(int node, std::vector<int>& ids, int limit) const;
+		// Add the IDs of names one edit from text[i...], at or below a node
+		bool add_typos(int node, const std::string& text, int i, bool edited, std::vector<int>& ids, int limit) const;
+	public:
+		enum Match{ EXACT, PREFIX, TYPO };
+		// Shortest text that TYPO matches
+		static const int MIN_TYPO_LENGTH = 3;
+		// Constructor, makes an empty trie
+		NameTrie();
+		/*
+		 * fold writes text the way names are stored: lower case, with
+		 * single spaces between words and none at the ends.
+		 *
+		 * Args:
+		 * text, the text to fold
+		 * folded, where to write it (its memory is reused)
+		 */
+		static void fold(std::string_view text, std::string& folded);
+		/*
+		 * insert adds a name.
+		 *
+		 * Args:
+		 * name, the name to add (folded before it's stored)
+		 * id, the name's ID, 0 or more
+		 */
+		void insert(std::string_view name, int id);
+		/*
+		 * find adds the IDs of the names that match some text to a list.
+		 * Each ID is added once.
+		 *
+		 * Args:
+		 * text, what the player typed
+		 * kind, the kind of match
+		 * ids, the list to add them to
+		 * limit, most IDs to add
+		 *
+		 * Returns:
+		 * False if more than limit names matched (then the list is cut short,
+		 * ex. for a prefix too short to mean anything in particular).
+		 */
+		bool find(std::string_view text, Match kind, std::vector<int>& ids, int limit) const;
+		/*
+		 * matches checks one name against some text, the same way find
+		 * would, without a trie (ex. for the few names in a room, when
+		 * find turned up too many names to list).
+		 *
+		 * Args:
+		 * name, the name (folded before it's compared)
+		 * text, what the player typed
+		 * kind, the kind of match
+		 *
+		 * Returns:
+		 * Whether find would match the name to the text.
+		 */
+		static bool matches(std::string_view name, std::string_view text, Match kind);
+};
+
+#endif
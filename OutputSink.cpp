@@ -0,0 +1,116 @@
+#include "OutputSink.h"
+#include <unistd.h> // For write()
+
+/*
+ * The output sinks a Game can write to: buffered to a file
+ * descriptor, thrown away, or kept in memory.
+ */
+
+// Constructor, points the sink's stream at the sink
+OutputSink::OutputSink() : output(this), byteCount(0){}
+
+OutputSink::~OutputSink(){}
+
+std::ostream& OutputSink::stream(){
+	return output;
+}
+
+// Bytes already passed on plus whatever is waiting in the put area
+unsigned long long OutputSink::bytes() const{
+	return byteCount + (pptr() - pbase());
+}
+
+BufferedSink::BufferedSink(int fd) : fd(fd), writeCount(0){
+	setp(block, block + sizeof(block));
+}
+
+BufferedSink::~BufferedSink(){
+	drain();
+}
+
+bool BufferedSink::drain(){
+	const char* data = pbase();
+	std::size_t size = pptr() - pbase();
+	byteCount += size;
+	setp(block, block + sizeof(block));
+	while (size > 0){
+		ssize_t written = ::write(fd, data, size);
+		writeCount++;
+		if (written <= 0){
+			return false;
+		}
+		data += written;
+		size -= written;
+	}
+	return true;
+}
+
+// Called when the block is full
+BufferedSink::int_type BufferedSink::overflow(int_type ch){
+	if (!drain()){
+		return traits_type::eof();
+	}
+	if (!traits_type::eq_int_type(ch, traits_type::eof())){
+		*pptr() = traits_type::to_char_type(ch);
+		pbump(1);
+	}
+	return traits_type::not_eof(ch);
+}
+
+// Called on flush; writes the whole block with one system call
+int BufferedSink::sync(){
+	return drain() ? 0 : -1;
+}
+
+unsigned long long BufferedSink::writes() const{
+	return writeCount;
+}
+
+NullSink::NullSink(){
+	setp(scratch, scratch + sizeof(scratch));
+}
+
+// Called when the scratch block is full; count it and start over
+NullSink::int_type NullSink::overflow(int_type ch){
+	byteCount += pptr() - pbase();
+	setp(scratch, scratch + sizeof(scratch));
+	if (!traits_type::eq_int_type(ch, traits_type::eof())){
+		byteCount++;
+	}
+	return traits_type::not_eof(ch);
+}
+
+int NullSink::sync(){
+	byteCount += pptr() - pbase();
+	setp(scratch, scratch + sizeof(scratch));
+	return 0;
+}
+
+// MemorySink has no put area, so every write comes through here
+MemorySink::MemorySink(){}
+
+MemorySink::int_type MemorySink::overflow(int_type ch){
+	if (!traits_type::eq_int_type(ch, traits_type::eof())){
+		contents += traits_type::to_char_type(ch);
+		byteCount++;
+	}
+	return traits_type::not_eof(ch);
+}
+
+std::streamsize MemorySink::xsputn(const char* s, std::streamsize count){
+	contents.append(s, count);
+	byteCount += count;
+	return count;
+}
+
+const std::string& MemorySink::str() const{
+	return contents;
+}
+
+void MemorySink::clear(){
+	contents.clear();
+}
+
+void MemorySink::reserve(std::size_t bytes){
+	contents.reserve(bytes);
+}
@@ -0,0 +1,86 @@
+#ifndef __OUTPUTSINK_H__ // INCLUDE GUARD
+#define __OUTPUTSINK_H__
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+/*
+ * Header file for OutputSink.cpp
+ * An OutputSink is where a Game's text ends up. Each sink is a
+ * stream buffer, so the game (and the operator<< overloads for
+ * Location, Item, and NPC) keep writing to a plain std::ostream,
+ * and the sink decides what happens to the characters:
+ *  BufferedSink  collects output in a fixed block and writes it to a
+ *                file descriptor (ex. stdout) only when flushed, which
+ *                Game::play does once per turn, or when the block fills
+ *  NullSink      throws everything away, for benchmarks
+ *  MemorySink    keeps everything in a string, for checking output
+ * Every sink counts the bytes written into it.
+ */
+
+class OutputSink : public std::streambuf{
+	private:
+		std::ostream output; // Stream that writes into this sink
+	protected:
+		unsigned long long byteCount; // Bytes passed on out of the put area so far
+	public:
+		OutputSink();
+		virtual ~OutputSink();
+		// The stream to hand to a Game (or anything else) to write into this sink
+		std::ostream& stream();
+		// Total bytes written into the sink so far
+		unsigned long long bytes() const;
+};
+
+class BufferedSink : public OutputSink{
+	private:
+		char block[1 << 16];
+		int fd; // File descriptor the output goes to
+		unsigned long long writeCount; // Number of write system calls made
+		// Write out everything in the block and reset it. Returns false if the write failed.
+		bool drain();
+	protected:
+		int_type overflow(int_type ch) override;
+		int sync() override;
+	public:
+		/*
+		 * Constructor
+		 *
+		 * Args:
+		 * The file descriptor to write to (ex. STDOUT_FILENO).
+		 */
+		BufferedSink(int fd);
+		// Writes out anything still buffered
+		~BufferedSink();
+		// Number of write system calls made so far
+		unsigned long long writes() const;
+};
+
+class NullSink : public OutputSink{
+	private:
+		char scratch[256]; // Output is written here and then dropped
+	protected:
+		int_type overflow(int_type ch) override;
+		int sync() override;
+	public:
+		NullSink();
+};
+
+class MemorySink : public OutputSink{
+	private:
+		std::string contents;
+	protected:
+		int_type overflow(int_type ch) override;
+		std::streamsize xsputn(const char* s, std::streamsize count) override;
+	public:
+		MemorySink();
+		// Everything written so far
+		const std::string& str() const;
+		// Throw away everything written so far (keeping the memory for reuse)
+		void clear();
+		// Make room for at least this many bytes in all, so writing up to that many doesn't allocate
+		void reserve(std::size_t bytes);
+};
+
+#endif
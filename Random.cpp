@@ -0,0 +1,59 @@
+#include "Random.h"
+#include <random> // For std::random_device
+
+/*
+ * Random is a small, fast, seedable random number generator
+ * (xoshiro256**). Includes functions to get a seed, draw
+ * random bits, and draw a random number below a limit.
+ */
+
+// splitmix64 step, used to spread a single seed over the whole state
+static std::uint64_t splitmix64(std::uint64_t& x){
+	std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+static std::uint64_t rotl(std::uint64_t x, int k){
+	return (x << k) | (x >> (64 - k));
+}
+
+// Constructor, fills the state from the seed
+Random::Random(std::uint64_t seed){
+	for (int i = 0; i < 4; i++){
+		state[i] = splitmix64(seed);
+	}
+}
+
+// Get a seed from the system's random device
+std::uint64_t Random::random_seed(){
+	std::random_device rd;
+	return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+}
+
+// Get the next 64 random bits (xoshiro256**)
+std::uint64_t Random::next(){
+	std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+	std::uint64_t t = state[1] << 17;
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotl(state[3], 45);
+	return result;
+}
+
+// Get a random number in [0, limit). Uses the multiply-shift method, rejecting
+// the few values that would make some numbers more likely than others.
+int Random::below(int limit){
+	std::uint64_t range = static_cast<std::uint64_t>(limit);
+	std::uint64_t threshold = (0x100000000ull - range) % range; // 2^32 mod range
+	while (true){
+		std::uint64_t product = (next() >> 32) * range;
+		if ((product & 0xFFFFFFFFull) >= threshold){
+			return static_cast<int>(product >> 32);
+		}
+	}
+}
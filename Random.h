@@ -0,0 +1,57 @@
+#ifndef __RANDOM_H__ // INCLUDE GUARD
+#define __RANDOM_H__
+
+#include <cstdint>
+
+/*
+ * Header file for Random.cpp
+ * Random is the random number generator a Game uses for everything
+ * random (teleports, stealing). It is seeded once when the game is made,
+ * so two games with the same seed and the same commands play out exactly
+ * the same, and drawing a number is a few arithmetic operations instead
+ * of reading the kernel's entropy source and seeding a new engine.
+ * The generator is xoshiro256**, seeded through splitmix64.
+ */
+
+class Random{
+	private:
+		std::uint64_t state[4];
+		// Snapshot saves and restores the state, so a restored game draws the same numbers
+		friend class Snapshot;
+	public:
+		/*
+		 * Constructor, seeds the generator.
+		 *
+		 * Args:
+		 * The seed. Any value is fine, including 0.
+		 */
+		Random(std::uint64_t seed);
+		/*
+		 * random_seed gets a seed from std::random_device, for games
+		 * that don't need to be repeatable.
+		 *
+		 * Returns:
+		 * A seed that is different every time.
+		 */
+		static std::uint64_t random_seed();
+		/*
+		 * next gets the next 64 random bits.
+		 *
+		 * Returns:
+		 * A random 64 bit number.
+		 */
+		std::uint64_t next();
+		/*
+		 * below gets a random number from 0 up to (not including) a
+		 * limit, with every number equally likely.
+		 *
+		 * Args:
+		 * The limit. Must be greater than 0.
+		 *
+		 * Returns:
+		 * A random integer between 0 and limit - 1.
+		 */
+		int below(int limit);
+};
+
+#endif
@@ -0,0 +1,277 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <vector>
+#include <unistd.h> // For STDOUT_FILENO
+#include "Game.h"
+#include "WorldLoader.h"
+#include "Snapshot.h"
+#include "OutputSink.h"
+#include "EventLog.h"
+
+/*
+ * Headless replay driver for GVZork.
+ * Streams commands from a script file (or from stdin when the
+ * script is "-") through Game::run_command at full speed, with no
+ * prompt, then reports how many commands per second were processed.
+ * Output goes to an OutputSink that is flushed once per command, the
+ * same as Game::play does once per turn. The script is read into memory once,
+ * so the timing only covers the dispatch path and not file reads.
+ * It also counts the heap allocations made while running commands.
+ * The first pass over the script warms the game up, and so does any
+ * later pass that takes the player into a room they haven't been in
+ * yet, since the first look at a room fills its entry in the look
+ * cache (see WorldState::render). Every other pass is the steady
+ * state, which should not allocate at all for scripts that don't end
+ * the game.
+ * When a game ends (win, loss, or quit) a new game is started, so
+ * long transcripts can be replayed back to back.
+ *
+ * Usage:
+ * replay <script|-> [--world <file>] [--seed N] [--repeat N] [--sink null|memory|stdout] [--load <file>] [--save <file>] [--record <file>]
+ *  --world <file>  play in a world read from a text or compiled world file
+ *  --seed N    seed for the first game (the next games use N + 1, N + 2, ...),
+ *              so the replay's output is the same every run
+ *  --repeat N  replay the whole script N times (default 1)
+ *  --sink      where the game output goes: null (thrown away, the default), memory
+ *              (kept in a string), or stdout (buffered, with the write calls counted)
+ *  --check-allocations  exit with status 1 if a steady state pass allocated memory
+ *              (passes that went into a room for the first time are warm-up)
+ *  --load <file>  start the first game from a snapshot (see Snapshot.h) instead of the start
+ *  --save <file>  save a snapshot of the last game once the script is done, so a later
+ *              replay with --load picks up where this one left off
+ *  --record <file>  record the events of every game into an event log (see EventLog.h),
+ *              written to the file once the script is done, for the events tool to replay
+ *              (the log grows as it goes, so recording allocates)
+ */
+
+// Number of heap allocations made so far. The replay is single threaded,
+// so this doesn't need to be atomic.
+static unsigned long long allocationCount = 0;
+
+// Count every allocation made through operator new (which the standard
+// containers also go through) and new[], with the deletes that match them.
+// They're all kept out of line, or GCC sees malloc() and free() paired with
+// the other kind of call where one is inlined, and warns they don't match.
+[[gnu::noinline]] void* operator new(std::size_t size){
+	allocationCount++;
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr){
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+[[gnu::noinline]] void* operator new[](std::size_t size){
+	return operator new(size);
+}
+
+[[gnu::noinline]] void operator delete(void* memory) noexcept{
+	std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept{
+	std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete[](void* memory) noexcept{
+	std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete[](void* memory, std::size_t) noexcept{
+	std::free(memory);
+}
+
+// Read the whole script into memory, from a file or from stdin if path is "-"
+static bool read_script(const std::string& path, std::string& script){
+	std::ostringstream contents;
+	if (path == "-"){
+		contents << std::cin.rdbuf();
+	} else {
+		std::ifstream file(path, std::ios::binary);
+		if (!file){
+			return false;
+		}
+		contents << file.rdbuf();
+	}
+	script = contents.str();
+	return true;
+}
+
+int main(int argc, char** argv){
+	std::string path;
+	std::string worldPath;
+	std::uint64_t seed = Random::random_seed();
+	long repeat = 1;
+	std::string sinkName = "null";
+	bool checkAllocations = false;
+	std::string loadPath;
+	std::string savePath;
+	std::string recordPath;
+	for (int a = 1; a < argc; a++){
+		std::string arg = argv[a];
+		if (arg == "--world" && a + 1 < argc){
+			worldPath = argv[++a];
+		} else if (arg == "--seed" && a + 1 < argc){
+			seed = std::stoull(argv[++a]);
+		} else if (arg == "--repeat" && a + 1 < argc){
+			repeat = std::stol(argv[++a]);
+		} else if (arg == "--sink" && a + 1 < argc){
+			sinkName = argv[++a];
+		} else if (arg == "--load" && a + 1 < argc){
+			loadPath = argv[++a];
+		} else if (arg == "--save" && a + 1 < argc){
+			savePath = argv[++a];
+		} else if (arg == "--record" && a + 1 < argc){
+			recordPath = argv[++a];
+		} else if (arg == "--check-allocations"){
+			checkAllocations = true;
+		} else if (path.empty()){
+			path = arg;
+		} else {
+			path.clear();
+			break;
+		}
+	}
+	if (path.empty() || repeat < 1 || (sinkName != "null" && sinkName != "memory" && sinkName != "stdout")){
+		std::cerr << "Usage: " << argv[0] << " <script|-> [--world <file>] [--seed N] [--repeat N] [--sink null|memory|stdout] [--load <file>] [--save <file>] [--record <file>] [--check-allocations]" << std::endl;
+		return 2;
+	}
+	std::string script;
+	if (!read_script(path, script)){
+		std::cerr << "Could not read script: " << path << std::endl;
+		return 1;
+	}
+
+	// Load the world once; every game in the replay shares its definition
+	std::shared_ptr<const WorldDefinition> world;
+	try {
+		world = std::make_shared<const WorldDefinition>(worldPath.empty() ? Game::create_world() : WorldLoader::load_world(worldPath));
+	} catch (const std::invalid_argument& e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	// Where the game output goes. The memory sink keeps growing, so it allocates in every pass
+	std::unique_ptr<OutputSink> sink;
+	BufferedSink* stdoutSink = nullptr;
+	if (sinkName == "stdout"){
+		stdoutSink = new BufferedSink(STDOUT_FILENO);
+		sink.reset(stdoutSink);
+	} else if (sinkName == "memory"){
+		sink.reset(new MemorySink());
+	} else {
+		sink.reset(new NullSink());
+	}
+	std::ostream& output = sink->stream();
+
+	// Every game records into the same log, one after another
+	std::unique_ptr<EventLog> events;
+	if (!recordPath.empty()){
+		events = std::make_unique<EventLog>(*world);
+	}
+
+	unsigned long long commandCount = 0;
+	unsigned long long gameCount = 1;
+	unsigned long long warmupAllocations = 0; // Allocations made by commands in warm-up passes
+	unsigned long long steadyAllocations = 0; // Allocations made by commands in every other pass
+	long warmupPasses = 0;
+	// Rooms the current game has run a command in; running one anywhere else makes the pass a warm-up
+	std::vector<bool> entered(world->location_count(), false);
+	bool newRoom = false; // Whether this pass ran a command in a room for the first time
+	auto enter = [&entered, &newRoom](int location){
+		if (!entered[location]){
+			entered[location] = true;
+			newRoom = true;
+		}
+	};
+	auto start = std::chrono::steady_clock::now();
+	Game* game = new Game(world, seed, output);
+	if (!loadPath.empty()){
+		try {
+			Snapshot::restore_file(*game, loadPath);
+		} catch (const std::invalid_argument& e){
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+	}
+	game->record_events(events.get());
+	for (long r = 0; r < repeat; r++){
+		std::string_view rest = script;
+		unsigned long long passAllocations = 0;
+		newRoom = (r == 0);
+		while (!rest.empty()){
+			// Cut the next line off the front of the script
+			std::size_t end = rest.find('\n');
+			std::string_view next = rest.substr(0, end);
+			rest = (end == std::string_view::npos) ? std::string_view() : rest.substr(end + 1);
+			if (!next.empty() && next.back() == '\r'){
+				next.remove_suffix(1);
+			}
+			// Start a fresh game once the last one is over
+			if (!game->is_in_progress()){
+				delete game;
+				game = new Game(world, seed + gameCount, output);
+				game->record_events(events.get());
+				gameCount++;
+				entered.assign(entered.size(), false); // The new game's look cache is empty
+			}
+			enter(game->current_location()); // The room the command runs in, which look renders
+			unsigned long long before = allocationCount;
+			game->run_command(next);
+			output.flush(); // End of the turn
+			passAllocations += allocationCount - before;
+			commandCount++;
+		}
+		if (newRoom){
+			warmupAllocations += passAllocations;
+			warmupPasses++;
+		} else {
+			steadyAllocations += passAllocations;
+		}
+	}
+	auto stop = std::chrono::steady_clock::now();
+
+
+	double seconds = std::chrono::duration<double>(stop - start).count();
+	std::cerr << "Commands: " << commandCount << "\n"
+		<< "Games: " << gameCount << "\n"
+		<< "Output bytes: " << sink->bytes() << "\n"
+		<< "Seconds: " << seconds << "\n"
+		<< "Commands/second: " << (seconds > 0 ? commandCount / seconds : 0.0) << "\n"
+		<< "Allocations (warm-up passes): " << warmupAllocations << " in " << warmupPasses << " pass" << (warmupPasses == 1 ? "" : "es") << "\n"
+		<< "Allocations (later passes): " << steadyAllocations << "\n";
+	if (stdoutSink != nullptr){
+		std::cerr << "Output writes: " << stdoutSink->writes() << " (" << (double)stdoutSink->writes() / commandCount << " per command)\n";
+	}
+	std::cerr << std::flush;
+	if (!savePath.empty()){
+		try {
+			Snapshot::save_file(*game, savePath);
+		} catch (const std::invalid_argument& e){
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+	}
+	delete game;
+	if (events != nullptr){
+		try {
+			events->save_file(recordPath);
+		} catch (const std::invalid_argument& e){
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+	}
+	if (checkAllocations && repeat > 1 && steadyAllocations > 0){
+		std::cerr << "Commands allocated memory after warming up." << std::endl;
+		return 1;
+	}
+	return 0;
+}
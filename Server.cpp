@@ -0,0 +1,94 @@
+#include <iostream>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <csignal>
+#include <atomic>
+#include <sys/resource.h> // For setrlimit
+#include "Game.h"
+#include "WorldLoader.h"
+#include "WorldDefinition.h"
+#include "SessionServer.h"
+
+/*
+ * Game server for GVZork.
+ * Hosts a game for every connection to a Unix domain socket, until
+ * it gets SIGINT or SIGTERM, then prints how many sessions it served
+ * (see SessionServer.h). Every line a client sends is one command, and
+ * the reply is the command's output followed by the prompt. Any client
+ * that can talk to a Unix socket works, ex. socat:
+ *  socat - UNIX-CONNECT:gvzork.sock
+ * The soft limit on open files is raised to the hard limit, so
+ * thousands of sessions can be connected at once.
+ *
+ * Usage:
+ * server [--socket <path>] [--threads N] [--seed N] [--world <file>]
+ *  --socket <path>  the socket to listen on (default gvzork.sock)
+ *  --threads N      number of event loop threads (default one per CPU core)
+ *  --seed N         session n's game is seeded with N + n (default 1)
+ *  --world <file>   play in a world read from a text or compiled world file
+ */
+
+// The server to stop when a signal comes in
+static std::atomic<SessionServer*> runningServer(nullptr);
+
+static void stop_server(int){
+	SessionServer* server = runningServer.load();
+	if (server != nullptr){
+		server->stop();
+	}
+}
+
+int main(int argc, char** argv){
+	ServerOptions options;
+	std::string worldPath;
+	try {
+		for (int a = 1; a < argc; a++){
+			std::string arg = argv[a];
+			if (a + 1 >= argc){
+				throw std::invalid_argument("Missing value for " + arg);
+			}
+			std::string value = argv[++a];
+			if (arg == "--socket"){
+				options.socketPath = value;
+			} else if (arg == "--threads"){
+				options.threads = std::stoi(value);
+			} else if (arg == "--seed"){
+				options.seed = std::stoull(value);
+			} else if (arg == "--world"){
+				worldPath = value;
+			} else {
+				throw std::invalid_argument("Unknown option " + arg);
+			}
+		}
+	} catch (const std::exception& e){
+		std::cerr << e.what() << "\nUsage: " << argv[0] << " [--socket <path>] [--threads N] [--seed N] [--world <file>]" << std::endl;
+		return 2;
+	}
+
+	rlimit files;
+	if (getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur < files.rlim_max){
+		files.rlim_cur = files.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &files);
+	}
+
+	ServerStats stats;
+	try {
+		std::shared_ptr<const WorldDefinition> world = std::make_shared<const WorldDefinition>(worldPath.empty() ? Game::create_world() : WorldLoader::load_world(worldPath));
+		SessionServer server(world, options);
+		runningServer = &server;
+		std::signal(SIGINT, stop_server);
+		std::signal(SIGTERM, stop_server);
+		std::cout << "Listening on " << options.socketPath << std::endl;
+		stats = server.run();
+		runningServer = nullptr;
+	} catch (const std::invalid_argument& e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	std::cout << "Sessions: " << stats.sessions << "\n"
+		<< "Commands: " << stats.commands << "\n"
+		<< "Games ended: " << stats.gamesEnded << std::endl;
+	return 0;
+}
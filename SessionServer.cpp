@@ -0,0 +1,264 @@
+#include "SessionServer.h"
+#include <algorithm> // For std::max
+#include <cerrno>
+#include <cstring> // For std::strerror
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/*
+ * SessionServer accepts connections on a Unix domain socket and
+ * plays a game for each one, spreading them over epoll event loops.
+ */
+
+// Most connections one wakeup accepts, so a burst of them is shared out between the loops
+static const int ACCEPT_BATCH = 64;
+// Most events handled per epoll_wait
+static const int EVENT_BATCH = 256;
+// Bytes read per wakeup of a session; level triggered, so the loop comes back for the rest
+static const int READ_SIZE = 4096;
+
+// What the server says after a game ends, the same as main
+static const std::string_view GOODBYE = "\nThanks for playing!\n";
+
+SessionServer::Session::Session(int fd, std::shared_ptr<const WorldDefinition> world, std::uint64_t seed) : fd(fd), sent(0),
+	waitingToSend(false), closing(false), game(std::move(world), seed, output.stream()),
+	loop(game.play_async()){
+}
+
+// Set up the listening socket and the eventfd for stopping
+SessionServer::SessionServer(std::shared_ptr<const WorldDefinition> world, const ServerOptions& options) : world(std::move(world)),
+	options(options), listenFd(-1), stopFd(-1), sessionCount(0){
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (options.socketPath.empty() || options.socketPath.size() >= sizeof(address.sun_path)){
+		throw std::invalid_argument("Socket path must be 1 to " + std::to_string(sizeof(address.sun_path) - 1) + " characters: " + options.socketPath);
+	}
+	options.socketPath.copy(address.sun_path, options.socketPath.size());
+	listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	stopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (listenFd < 0 || stopFd < 0){
+		int error = errno;
+		close_sockets();
+		throw std::invalid_argument(std::string("Could not create socket: ") + std::strerror(error));
+	}
+	::unlink(options.socketPath.c_str());
+	if (::bind(listenFd, (const sockaddr*)&address, sizeof(address)) < 0 || ::listen(listenFd, SOMAXCONN) < 0){
+		int error = errno;
+		close_sockets();
+		throw std::invalid_argument("Could not listen on " + options.socketPath + ": " + std::strerror(error));
+	}
+}
+
+SessionServer::~SessionServer(){
+	close_sockets();
+}
+
+void SessionServer::close_sockets(){
+	if (listenFd >= 0){
+		::close(listenFd);
+		::unlink(options.socketPath.c_str());
+		listenFd = -1;
+	}
+	if (stopFd >= 0){
+		::close(stopFd);
+		stopFd = -1;
+	}
+}
+
+// Start a loop per thread, each with its own epoll instance watching the listening socket and the eventfd
+ServerStats SessionServer::run(){
+	int threadCount = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+	loops = std::vector<Loop>(threadCount);
+	for (Loop& loop : loops){
+		loop.epoll = ::epoll_create1(EPOLL_CLOEXEC);
+		epoll_event listenEvent{};
+		listenEvent.events = EPOLLIN | EPOLLEXCLUSIVE;
+		listenEvent.data.fd = listenFd;
+		epoll_event stopEvent{};
+		stopEvent.events = EPOLLIN;
+		stopEvent.data.fd = stopFd;
+		if (loop.epoll < 0 || ::epoll_ctl(loop.epoll, EPOLL_CTL_ADD, listenFd, &listenEvent) < 0
+			|| ::epoll_ctl(loop.epoll, EPOLL_CTL_ADD, stopFd, &stopEvent) < 0){
+			int error = errno;
+			for (Loop& made : loops){
+				if (made.epoll >= 0){
+					::close(made.epoll);
+				}
+			}
+			loops.clear();
+			throw std::invalid_argument(std::string("Could not set up epoll: ") + std::strerror(error));
+		}
+	}
+	std::vector<std::thread> threads;
+	for (int t = 1; t < threadCount; t++){
+		threads.emplace_back(&SessionServer::run_loop, this, std::ref(loops[t]));
+	}
+	run_loop(loops[0]);
+	for (std::thread& thread : threads){
+		thread.join();
+	}
+	// Add up the totals, and close the sessions still open
+	ServerStats total;
+	for (Loop& loop : loops){
+		total.sessions += loop.stats.sessions;
+		total.commands += loop.stats.commands;
+		total.gamesEnded += loop.stats.gamesEnded;
+		while (!loop.sessions.empty()){
+			close_session(loop, *loop.sessions.begin()->second);
+		}
+		::close(loop.epoll);
+	}
+	loops.clear();
+	return total;
+}
+
+// Writing to the eventfd is async-signal-safe, and it stays readable, so every loop sees it
+void SessionServer::stop(){
+	std::uint64_t one = 1;
+	[[maybe_unused]] ssize_t written = ::write(stopFd, &one, sizeof(one));
+}
+
+void SessionServer::run_loop(Loop& loop){
+	epoll_event events[EVENT_BATCH];
+	while (true){
+		int count = ::epoll_wait(loop.epoll, events, EVENT_BATCH, -1);
+		if (count < 0){
+			if (errno == EINTR){
+				continue;
+			}
+			return;
+		}
+		for (int e = 0; e < count; e++){
+			int fd = events[e].data.fd;
+			if (fd == stopFd){
+				return;
+			}
+			if (fd == listenFd){
+				accept_sessions(loop);
+				continue;
+			}
+			// The session may have been closed by an earlier event in this batch
+			auto found = loop.sessions.find(fd);
+			if (found == loop.sessions.end()){
+				continue;
+			}
+			Session& session = *found->second;
+			if (events[e].events & (EPOLLERR | EPOLLHUP)){
+				close_session(loop, session);
+			} else if (events[e].events & EPOLLOUT){
+				send_output(loop, session);
+			} else if (events[e].events & EPOLLIN){
+				receive(loop, session);
+			}
+		}
+	}
+}
+
+void SessionServer::accept_sessions(Loop& loop){
+	for (int a = 0; a < ACCEPT_BATCH; a++){
+		int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0){
+			return; // EAGAIN when there are none left; otherwise (ex. out of file descriptors) try again next wakeup
+		}
+		std::uint64_t number = sessionCount.fetch_add(1, std::memory_order_relaxed);
+		std::unique_ptr<Session> made = std::make_unique<Session>(fd, world, options.seed + number);
+		Session& session = *made;
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if (::epoll_ctl(loop.epoll, EPOLL_CTL_ADD, fd, &event) < 0){
+			::close(fd);
+			continue;
+		}
+		loop.sessions.emplace(fd, std::move(made));
+		loop.stats.sessions++;
+		send_output(loop, session); // The welcome and first prompt, written when the game's loop started
+	}
+}
+
+void SessionServer::receive(Loop& loop, Session& session){
+	char buffer[READ_SIZE];
+	ssize_t received = ::recv(session.fd, buffer, sizeof(buffer), 0);
+	if (received <= 0){
+		if (received < 0 && (errno == EAGAIN || errno == EINTR)){
+			return;
+		}
+		close_session(loop, session); // The client hung up
+		return;
+	}
+	session.input.append(buffer, received);
+	// Run every whole line, the same as Game::play would read them (without the newline, or a \r before it)
+	std::size_t start = 0;
+	std::size_t newline;
+	while (!session.closing && (newline = session.input.find('\n', start)) != std::string::npos){
+		std::string_view line(session.input.data() + start, newline - start);
+		if (!line.empty() && line.back() == '\r'){
+			line.remove_suffix(1);
+		}
+		session.loop.feed(line); // Runs the command, then prompts for the next unless the game is over
+		loop.stats.commands++;
+		if (session.loop.done()){
+			session.output.stream() << GOODBYE;
+			session.closing = true;
+			loop.stats.gamesEnded++;
+		}
+		start = newline + 1;
+	}
+	session.input.erase(0, start);
+	if (session.input.size() > static_cast<std::size_t>(options.maxLine)){
+		close_session(loop, session);
+		return;
+	}
+	send_output(loop, session);
+}
+
+void SessionServer::send_output(Loop& loop, Session& session){
+	const std::string& output = session.output.str();
+	while (session.sent < output.size()){
+		ssize_t written = ::send(session.fd, output.data() + session.sent, output.size() - session.sent, MSG_NOSIGNAL);
+		if (written < 0){
+			if (errno == EINTR){
+				continue;
+			}
+			if (errno == EAGAIN){
+				watch(loop, session, true);
+			} else {
+				close_session(loop, session);
+			}
+			return;
+		}
+		session.sent += written;
+	}
+	session.output.clear();
+	session.sent = 0;
+	if (session.closing){
+		close_session(loop, session);
+		return;
+	}
+	watch(loop, session, false);
+}
+
+void SessionServer::watch(Loop& loop, Session& session, bool forOutput){
+	if (session.waitingToSend == forOutput){
+		return;
+	}
+	epoll_event event{};
+	event.events = forOutput ? EPOLLOUT : EPOLLIN;
+	event.data.fd = session.fd;
+	::epoll_ctl(loop.epoll, EPOLL_CTL_MOD, session.fd, &event);
+	session.waitingToSend = forOutput;
+}
+
+// Closing the descriptor also takes it out of the epoll instance
+void SessionServer::close_session(Loop& loop, Session& session){
+	int fd = session.fd;
+	::close(fd);
+	loop.sessions.erase(fd); // Frees the session, so it can't be used after this
+}
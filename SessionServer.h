@@ -0,0 +1,128 @@
+#ifndef __SESSIONSERVER_H__ // INCLUDE GUARD
+#define __SESSIONSERVER_H__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Game.h"
+#include "WorldDefinition.h"
+#include "OutputSink.h"
+#include "GameLoop.h"
+
+/*
+ * Header file for SessionServer.cpp
+ * SessionServer hosts many games at once in one process, one per
+ * connection to a Unix domain socket. Each connection is a session: the
+ * client sends commands one per line, the same as typing them into
+ * Game::play, and gets back the game's output followed by the prompt.
+ * Every session's Game shares one WorldDefinition, so a session only
+ * costs memory for what its game has changed (see WorldState.h).
+ *
+ * The sessions are spread over a few event loop threads. Each thread has
+ * its own epoll instance, and the listening socket is added to all of
+ * them with EPOLLEXCLUSIVE, so a new connection wakes one thread, which
+ * accepts it and keeps it from then on. A session is only ever touched by
+ * the thread that owns it, so running its commands doesn't need any locks.
+ *
+ * Each session's game runs as a coroutine (Game::play_async), which the
+ * loop feeds the session's lines as they arrive, so a waiting player is
+ * a suspended coroutine rather than a blocked thread. The output
+ * collects in the session's MemorySink until the turn is done, then goes
+ * out in one send. When the
+ * client is slow to read, the rest waits for EPOLLOUT, and the session
+ * stops reading commands until it has all been sent, so neither buffer
+ * grows without bound. Once a game ends the session sends what's left
+ * and closes the connection.
+ */
+
+// Settings for a server
+struct ServerOptions{
+	std::string socketPath = "gvzork.sock"; // Path of the Unix domain socket to listen on
+	int threads = 0; // Number of event loop threads, 0 for one per CPU core
+	std::uint64_t seed = 1; // Session n's game uses seed + n, so a session can be played again offline
+	int maxLine = 4096; // Sessions sending a line longer than this many bytes are disconnected
+};
+
+// Totals over everything a server has done, once it has stopped
+struct ServerStats{
+	std::uint64_t sessions = 0; // Connections accepted
+	std::uint64_t commands = 0; // Lines fed to the games
+	std::uint64_t gamesEnded = 0; // Sessions closed because their game was won, lost, or quit
+};
+
+class SessionServer{
+	private:
+		// One connection and its game
+		struct Session{
+			int fd; // The connection
+			std::string input; // Bytes received that don't make a whole line yet
+			MemorySink output; // The game's output not sent yet; made before game, which writes into it
+			std::size_t sent; // How much of output has been sent
+			bool waitingToSend; // Whether the session is waiting for EPOLLOUT instead of reading
+			bool closing; // Whether the game is over, so the session closes once output has been sent
+			Game game;
+			GameLoop loop; // The game's loop, made after the game it runs
+			Session(int fd, std::shared_ptr<const WorldDefinition> world, std::uint64_t seed);
+		};
+		// One event loop thread and the sessions it owns
+		struct Loop{
+			int epoll = -1;
+			std::unordered_map<int, std::unique_ptr<Session>> sessions; // By file descriptor
+			ServerStats stats;
+		};
+		std::shared_ptr<const WorldDefinition> world;
+		ServerOptions options;
+		int listenFd; // The listening socket
+		int stopFd; // An eventfd that every loop watches; stop makes it readable
+		std::atomic<std::uint64_t> sessionCount; // Number of sessions started, for their seeds
+		std::vector<Loop> loops;
+		// Run one thread's event loop until stop is called
+		void run_loop(Loop& loop);
+		// Accept the waiting connections, up to a batch, and start their sessions
+		void accept_sessions(Loop& loop);
+		// Read what a session's client sent and run the whole lines in it
+		void receive(Loop& loop, Session& session);
+		// Send as much of a session's output as the socket takes, then close it if its game is over
+		void send_output(Loop& loop, Session& session);
+		// Change which events a session's loop waits for
+		void watch(Loop& loop, Session& session, bool forOutput);
+		// Close a session's connection and free it
+		void close_session(Loop& loop, Session& session);
+		// Close the listening socket and the eventfd, and remove the socket's path
+		void close_sockets();
+	public:
+		/*
+		 * Constructor that starts listening on the socket. Anything already
+		 * at the socket's path is removed first (ex. left over from a server
+		 * that was killed).
+		 *
+		 * Args:
+		 * world, the world every session plays in
+		 * options, the server settings
+		 *
+		 * Throws std::invalid_argument if the socket can't be set up.
+		 */
+		SessionServer(std::shared_ptr<const WorldDefinition> world, const ServerOptions& options);
+		// Closes the socket and removes its path (run closes the sessions before it returns)
+		~SessionServer();
+		SessionServer(const SessionServer&) = delete;
+		SessionServer& operator=(const SessionServer&) = delete;
+		/*
+		 * run serves sessions on the event loop threads, and returns
+		 * once stop has been called and every thread has seen it.
+		 *
+		 * Returns:
+		 * The totals over every thread.
+		 */
+		ServerStats run();
+		/*
+		 * stop makes run return. It only writes to an eventfd, so it can be
+		 * called from any thread, or from a signal handler (ex. for SIGINT).
+		 */
+		void stop();
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "ShardRuntime.h"
+#include "SymbolTable.h"
+#include <algorithm> // For std::max and std::min
+#include <utility>
+
+/*
+ * ShardRuntime runs each player's lines on the shard thread that
+ * owns the player's room, handing players between shards through
+ * lock-free queues as they move.
+ */
+
+// Most lines a player runs before the shard moves on to the next player, so one busy player can't hold up the rest
+static const int PLAYER_BATCH = 16;
+
+ShardRuntime::Player::Player(int number, std::shared_ptr<SharedWorld> world, std::uint64_t seed, std::ostream& output) : number(number),
+	session(std::move(world), seed, output), scheduled(false), shard(0){
+}
+
+ShardRuntime::Player::~Player(){
+	while (Line* line = inbox.pop()){
+		delete line;
+	}
+}
+
+int ShardRuntime::Player::id() const{
+	return number;
+}
+
+Game& ShardRuntime::Player::game(){
+	return session;
+}
+
+// The world's rooms belong to the shards, so it's made without room locks
+ShardRuntime::ShardRuntime(std::shared_ptr<const WorldDefinition> world, int shardCount, TurnFunction turn) : world(std::make_shared<SharedWorld>(world, false)),
+	locationCount(world->location_count()), turn(std::move(turn)), stopping(false){
+	if (shardCount <= 0){
+		shardCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	shardCount = std::min(shardCount, locationCount); // Every shard owns at least one room
+	// The world is loaded, so no more names are coming; from here on the shards look names up without a lock
+	SymbolTable::global().freeze();
+	for (int s = 0; s < shardCount; s++){
+		shards.emplace_back(std::make_unique<Shard>());
+	}
+	for (int s = 0; s < shardCount; s++){
+		shards[s]->thread = std::thread(&ShardRuntime::run_shard, this, s);
+	}
+}
+
+ShardRuntime::~ShardRuntime(){
+	stopping.store(true);
+	for (std::unique_ptr<Shard>& shard : shards){
+		shard->wakeups.fetch_add(1);
+		shard->wakeups.notify_all();
+	}
+	for (std::unique_ptr<Shard>& shard : shards){
+		shard->thread.join();
+	}
+}
+
+// Shards own blocks of consecutive locations, so exits between nearby rooms mostly stay on one shard
+int ShardRuntime::shard_of(int location) const{
+	return static_cast<long long>(location) * shards.size() / locationCount;
+}
+
+ShardRuntime::Player& ShardRuntime::join(std::uint64_t seed, std::ostream& output){
+	std::lock_guard<std::mutex> guard(joining);
+	players.emplace_back(std::make_unique<Player>(players.size(), world, seed, output));
+	Player& player = *players.back();
+	player.shard = shard_of(player.session.current_location());
+	return player;
+}
+
+void ShardRuntime::submit(Player& player, std::string line){
+	Player::Line* waiting = new Player::Line();
+	waiting->text = std::move(line);
+	player.inbox.push(waiting);
+	schedule(player);
+}
+
+// Whoever sets the scheduled flag queues the player, so they're on at most one queue
+void ShardRuntime::schedule(Player& player){
+	if (!player.scheduled.exchange(true)){
+		send(player, player.shard);
+	}
+}
+
+// wakeups only changes after the push is done, so a shard that saw the queue empty before it will see the change
+void ShardRuntime::send(Player& player, int shard){
+	Shard& to = *shards[shard];
+	to.ready.push(&player);
+	to.wakeups.fetch_add(1, std::memory_order_release);
+	to.wakeups.notify_one();
+}
+
+void ShardRuntime::run_shard(int shard){
+	Shard& self = *shards[shard];
+	while (!stopping.load(std::memory_order_relaxed)){
+		std::uint32_t seen = self.wakeups.load(std::memory_order_acquire);
+		Player* player = self.ready.pop();
+		if (player != nullptr){
+			run_player(shard, *player);
+		} else {
+			// Sleep until another push (or stopping) changes wakeups
+			self.wakeups.wait(seen, std::memory_order_acquire);
+		}
+	}
+}
+
+void ShardRuntime::run_player(int shard, Player& player){
+	Shard& self = *shards[shard];
+	for (int n = 0; n < PLAYER_BATCH; n++){
+		Player::Line* line = player.inbox.pop();
+		if (line == nullptr){
+			// Out of lines, so the player goes idle. A line sent before the flag was cleared
+			// didn't queue the player (it was still set), so check for one and queue them again
+			player.scheduled.store(false);
+			if (!player.inbox.empty() && !player.scheduled.exchange(true)){
+				send(player, shard);
+			}
+			return;
+		}
+		player.session.run_command(line->text);
+		delete line;
+		self.commands.store(self.commands.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		if (turn){
+			turn(player);
+		}
+		// The command took the player to another shard's room, so the rest of their lines run there
+		int owner = shard_of(player.session.current_location());
+		if (owner != shard){
+			player.shard = owner;
+			self.handoffs.store(self.handoffs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			send(player, owner);
+			return;
+		}
+	}
+	// Used up the batch, so go to the back of the queue
+	send(player, shard);
+}
+
+int ShardRuntime::shard_count() const{
+	return shards.size();
+}
+
+std::uint64_t ShardRuntime::commands() const{
+	std::uint64_t total = 0;
+	for (const std::unique_ptr<Shard>& shard : shards){
+		total += shard->commands.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+std::uint64_t ShardRuntime::handoffs() const{
+	std::uint64_t total = 0;
+	for (const std::unique_ptr<Shard>& shard : shards){
+		total += shard->handoffs.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+int ShardRuntime::misplaced_items() const{
+	std::vector<const Game*> everyone;
+	for (const std::unique_ptr<Player>& player : players){
+		everyone.push_back(&player->session);
+	}
+	return world->misplaced_items(everyone);
+}
@@ -0,0 +1,158 @@
+#ifndef __SHARDRUNTIME_H__ // INCLUDE GUARD
+#define __SHARDRUNTIME_H__
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Game.h"
+#include "SharedWorld.h"
+#include "WorldDefinition.h"
+#include "MpscQueue.h"
+
+/*
+ * Header file for ShardRuntime.cpp
+ * ShardRuntime plays many players in one SharedWorld, split up by room
+ * instead of locked room by room. The locations are cut into one block
+ * of consecutive indexes per shard, and each shard is a thread that owns
+ * its rooms outright: their items, their NPCs, and the players in them.
+ * Only a room's shard ever runs commands there, so the world's rooms
+ * need no locks at all (the SharedWorld is made without them).
+ *
+ * Each player is an actor. Their lines of input go into their own
+ * inbox, and a player with input waiting is queued on the shard that
+ * owns their room, which runs their lines through Game::run_command
+ * (the same command handlers as every other game). When a command takes
+ * the player into a room of another shard (going through an exit, or a
+ * teleport), the player is handed over, inbox and all, by queueing them
+ * on the new shard. The inboxes and the shards' queues are lock-free
+ * MpscQueues, so nothing between shards waits on a lock either, and
+ * with players spread over the world, shards only deal with each other
+ * when a player crosses from one block of rooms to the next.
+ *
+ * What's left of the state that shards share is safe without locks
+ * (see SharedWorld.h): the visited flags neighbors' look reads, the shop's
+ * counter, and the item slots, which are only written by whoever has
+ * the item, and an item is only ever in one room or one inventory.
+ * Commands look names up in the global SymbolTable, which the runtime
+ * freezes when it's made (see SymbolTable::freeze), so those reads take
+ * no lock either. Every world has to be loaded before a runtime is made.
+ *
+ * A player's lines run in the order they were sent, one at a time, so a
+ * player's game and output are only used by one thread at once. After
+ * each line, the runtime calls the turn function (if there is one) on
+ * the shard's thread, ex. to send the output to the player, or to send
+ * a bot's next line.
+ */
+
+class ShardRuntime{
+	public:
+		// One player in the world: their game, and the lines waiting to be run
+		class Player : public MpscNode{
+			private:
+				// One line waiting in a player's inbox
+				struct Line : public MpscNode{
+					std::string text;
+				};
+				int number; // The order the player joined in, from 0
+				Game session; // The player's game
+				MpscQueue<Line> inbox;
+				std::atomic<bool> scheduled; // Whether the player is queued on a shard or running, so they aren't queued twice
+				int shard; // The shard the player is on, only changed while scheduled
+				friend class ShardRuntime;
+			public:
+				Player(int number, std::shared_ptr<SharedWorld> world, std::uint64_t seed, std::ostream& output);
+				// Frees the lines that were never run
+				~Player();
+				// The order the player joined in, from 0 (ex. to keep data about each player in a vector)
+				int id() const;
+				// The player's game. Only use it from the turn function, or when no lines are waiting
+				Game& game();
+		};
+		// Called on the shard's thread after each of a player's lines is run
+		typedef std::function<void(Player& player)> TurnFunction;
+	private:
+		// One shard: its thread, and the players with lines waiting in its rooms
+		struct alignas(64) Shard{
+			MpscQueue<Player> ready;
+			std::atomic<std::uint32_t> wakeups{0}; // Goes up on every push, so a sleeping shard can wait for it to change
+			std::atomic<std::uint64_t> commands{0}; // Lines run on this shard (only written by its thread)
+			std::atomic<std::uint64_t> handoffs{0}; // Players sent on to another shard (only written by its thread)
+			std::thread thread;
+		};
+		std::shared_ptr<SharedWorld> world;
+		int locationCount;
+		std::vector<std::unique_ptr<Shard>> shards;
+		TurnFunction turn;
+		std::atomic<bool> stopping;
+		std::mutex joining; // Held while adding a player to players
+		std::vector<std::unique_ptr<Player>> players;
+		// The shard that owns a location
+		int shard_of(int location) const;
+		// Queue a player on a shard, and wake it if it's asleep
+		void send(Player& player, int shard);
+		// Queue a player on their shard if they aren't already queued or running
+		void schedule(Player& player);
+		// Run a shard until the runtime stops
+		void run_shard(int shard);
+		// Run up to a batch of a player's lines, then hand them on, queue them again, or let them go idle
+		void run_player(int shard, Player& player);
+	public:
+		/*
+		 * Constructor, which freezes the global SymbolTable and starts
+		 * the shards' threads.
+		 *
+		 * Args:
+		 * world, the world to play in
+		 * shardCount, the number of shards (threads), 0 for one per CPU core
+		 * turn, called after each line a player sends is run, on the shard's thread (can be empty)
+		 */
+		ShardRuntime(std::shared_ptr<const WorldDefinition> world, int shardCount, TurnFunction turn);
+		// Stops the shards; lines still waiting are never run
+		~ShardRuntime();
+		ShardRuntime(const ShardRuntime&) = delete;
+		ShardRuntime& operator=(const ShardRuntime&) = delete;
+		/*
+		 * join adds a player to the world, at a random location. Can be
+		 * called from any thread, while other players are playing.
+		 *
+		 * Args:
+		 * seed, the seed for the player's game
+		 * output, where the player's game writes; it must outlive the runtime
+		 *
+		 * Returns:
+		 * The player, who lives as long as the runtime.
+		 */
+		Player& join(std::uint64_t seed, std::ostream& output);
+		/*
+		 * submit sends a player a line of input, to run on the shard that has
+		 * them once the lines sent before it have run. Lock-free, and can be
+		 * called from any thread (including from the turn function).
+		 *
+		 * Args:
+		 * player, the player the line is from
+		 * line, one line of user input
+		 */
+		void submit(Player& player, std::string line);
+		// Number of shards
+		int shard_count() const;
+		// Lines run so far, over every shard. Only exact once no lines are waiting
+		std::uint64_t commands() const;
+		// Times a player was handed from one shard to another. Only exact once no lines are waiting
+		std::uint64_t handoffs() const;
+		/*
+		 * misplaced_items checks every item is in one place (see
+		 * SharedWorld::misplaced_items). Only call it when no lines are waiting.
+		 *
+		 * Returns:
+		 * The number of misplaced items, 0 if every transfer was atomic.
+		 */
+		int misplaced_items() const;
+};
+
+#endif
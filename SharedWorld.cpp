@@ -0,0 +1,61 @@
+#include "SharedWorld.h"
+#include "Game.h"
+#include <thread>
+#include <utility>
+
+/*
+ * SharedWorld sets up one WorldState for many players, with a
+ * lock per room, and checks afterwards that no item was lost or
+ * ended up in two places.
+ */
+
+RoomLock::RoomLock() : locked(false){
+}
+
+// Try to take the lock, and while someone else has it, wait for it to look free before trying again
+void RoomLock::lock(){
+	while (locked.exchange(true, std::memory_order_acquire)){
+		while (locked.load(std::memory_order_relaxed)){
+			std::this_thread::yield();
+		}
+	}
+}
+
+void RoomLock::unlock(){
+	locked.store(false, std::memory_order_release);
+}
+
+// Copy the starting state, then unshare all of it, so players' writes never copy a leaf another thread is using
+SharedWorld::SharedWorld(std::shared_ptr<const WorldDefinition> world, bool lockRooms) : world(std::move(world)),
+	state(std::make_shared<WorldState>(this->world->start_state())), locks(lockRooms ? new RoomLock[this->world->location_count()] : nullptr){
+	state->rooms.unshare();
+	state->npcs.unshare();
+	state->slots.slots.unshare();
+}
+
+// Go through every room and inventory, checking each item's slot and that nothing is in two places or none
+int SharedWorld::misplaced_items(const std::vector<const Game*>& players) const{
+	const WorldState& current = *state;
+	std::vector<int> places(world->items.size(), 0); // Lists each item was found in
+	int misplaced = 0;
+	auto check = [&](const std::vector<ItemHandle>& list){
+		for (int i = 0; i < static_cast<int>(list.size()); i++){
+			if (places[list[i]]++ > 0 || current.slots.slot(list[i]) != i){
+				misplaced++;
+			}
+		}
+	};
+	for (int l = 0; l < world->location_count(); l++){
+		check(current.items(l));
+	}
+	for (const Game* player : players){
+		check(player->inventory.items());
+	}
+	// Items with a slot but in no list were lost (eaten and unsold items have no slot)
+	for (ItemHandle item = 0; item < static_cast<ItemHandle>(places.size()); item++){
+		if (places[item] == 0 && current.slots.slot(item) >= 0){
+			misplaced++;
+		}
+	}
+	return misplaced;
+}
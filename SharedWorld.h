@@ -0,0 +1,88 @@
+#ifndef __SHAREDWORLD_H__ // INCLUDE GUARD
+#define __SHAREDWORLD_H__
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "WorldDefinition.h"
+#include "WorldState.h"
+
+class Game;
+
+/*
+ * Header file for SharedWorld.cpp
+ * A SharedWorld is one world that many players play in at once, from
+ * any number of threads: they see each other's changes, so an item one
+ * player takes is gone for everyone, and a dropped one is there for
+ * whoever comes by next. Each player is a Game made from the SharedWorld
+ * (see Game's constructor), with their own inventory, location, coins,
+ * and calories left to feed the Elf, but one WorldState between them.
+ *
+ * Every location has its own lock, and a player's command holds the lock
+ * of the room they're in while it runs (see Game::run_command). Commands
+ * only ever change the room the player is in when they start, so players
+ * in different rooms never wait for each other, and two players in one
+ * room take turns. That makes moving an item atomic: take and give move
+ * its handle between the room and the inventory under the room's lock,
+ * so every item is in exactly one place, whoever else is trying to take it.
+ *
+ * The rest of the state is safe to share without a room's lock:
+ *  - a room's visited flag is read by its neighbors' look (which prints
+ *    its name once anyone has visited it), so it's a RelaxedAtomic
+ *  - the shop sells its items in order through an atomic counter
+ *  - each item's slot (see ItemSlots) is only written by whoever has
+ *    the item: the player carrying it, or a player holding its room's lock
+ * The state's CowArrays are unshared when the world is made, so those
+ * writes never copy a leaf that other threads are using.
+ *
+ * Games in a shared world can't be forked or snapshotted, since the
+ * state they'd copy is changing under them.
+ */
+
+// A lock for one room, a single byte since worlds can have millions of
+// rooms. Commands are short, so it spins, yielding the CPU between tries.
+class RoomLock{
+	private:
+		std::atomic<bool> locked;
+	public:
+		RoomLock();
+		void lock();
+		void unlock();
+};
+
+class SharedWorld{
+	private:
+		std::shared_ptr<const WorldDefinition> world; // What doesn't change, shared the same as by games with their own state
+		std::shared_ptr<WorldState> state; // The state every player changes, held by each of their Games too
+		std::unique_ptr<RoomLock[]> locks; // One per location, by location index (nullptr if the rooms aren't locked)
+		// Friend of Game so games can find the world, its state, and the locks without getters
+		friend class Game;
+	public:
+		/*
+		 * Constructor, for a world where nothing has happened yet.
+		 *
+		 * Args:
+		 * world, the world to play in. The definition can be shared with other
+		 * SharedWorlds and with single player games at the same time.
+		 * lockRooms, false to leave out the room locks when something else
+		 * makes sure only one thread at a time runs commands in each room
+		 * (ex. ShardRuntime, where every room belongs to one thread)
+		 */
+		SharedWorld(std::shared_ptr<const WorldDefinition> world, bool lockRooms = true);
+		/*
+		 * misplaced_items checks that every item is where the state says
+		 * it is, ex. after a stress test. Must not be called while any of
+		 * the players are running commands.
+		 *
+		 * Args:
+		 * Every player in the world.
+		 *
+		 * Returns:
+		 * The number of items in more than one place, in a slot other than
+		 * the one ItemSlots says, or in a slot of an item that is nowhere.
+		 * 0 if every transfer was atomic.
+		 */
+		int misplaced_items(const std::vector<const Game*>& players) const;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include "Game.h"
+#include "Simulator.h"
+#include "WorldLoader.h"
+
+/*
+ * Monte Carlo simulation driver for GVZork.
+ * Plays many games with a computer player strategy across all
+ * CPU cores, and prints the win rate and a histogram of how many
+ * turns the wins took.
+ *
+ * Usage:
+ * simulate [--strategy random|forager] [--games N] [--threads N] [--seed N]
+ *          [--max-turns N] [--loot-calories N] [--world <file>] [--check-inventory]
+ *  --strategy       the computer player's strategy (default forager, see Simulator.h)
+ *  --games N        number of games to play (default 100000)
+ *  --threads N      number of threads (default one per CPU core)
+ *  --seed N         game n is seeded with N + n (default 1)
+ *  --max-turns N    games still going after N turns are timeouts (default 1000)
+ *  --loot-calories N  forager: calories to collect before feeding the Elf
+ *  --world <file>   play in a world read from a text or compiled world file
+ *  --check-inventory  after every turn, check the inventory's running totals against
+ *                   adding them up from scratch; exits with status 1 if any were wrong
+ */
+
+int main(int argc, char** argv){
+	SimulationOptions options;
+	std::string worldPath;
+	try {
+		for (int a = 1; a < argc; a++){
+			std::string arg = argv[a];
+			if (arg == "--check-inventory"){
+				options.checkInventory = true;
+				continue;
+			}
+			if (a + 1 >= argc){
+				throw std::invalid_argument("Missing value for " + arg);
+			}
+			std::string value = argv[++a];
+			if (arg == "--strategy"){
+				options.strategy = value;
+			} else if (arg == "--games"){
+				options.games = std::stoull(value);
+			} else if (arg == "--threads"){
+				options.threads = std::stoi(value);
+			} else if (arg == "--seed"){
+				options.seed = std::stoull(value);
+			} else if (arg == "--max-turns"){
+				options.maxTurns = std::stoi(value);
+			} else if (arg == "--loot-calories"){
+				options.lootCalories = std::stoi(value);
+			} else if (arg == "--world"){
+				worldPath = value;
+			} else {
+				throw std::invalid_argument("Unknown option " + arg);
+			}
+		}
+		if (options.games >= (1ull << 32) || options.maxTurns < 1){
+			throw std::invalid_argument("--games must be less than 2^32 and --max-turns at least 1");
+		}
+	} catch (const std::exception& e){
+		std::cerr << e.what() << "\nUsage: " << argv[0] << " [--strategy random|forager] [--games N] [--threads N] [--seed N] [--max-turns N] [--loot-calories N] [--world <file>] [--check-inventory]" << std::endl;
+		return 2;
+	}
+
+	SimulationResult result;
+	try {
+		World world = worldPath.empty() ? Game::create_world() : WorldLoader::load_world(worldPath);
+		result = Simulator::run(world, options);
+	} catch (const std::invalid_argument& e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	std::uint64_t games = result.wins + result.losses + result.timeouts;
+	std::cout << "Strategy: " << options.strategy << "\n"
+		<< "Games: " << games << " in " << result.seconds << " seconds (" << (result.seconds > 0 ? games / result.seconds : 0.0) << " games/second)\n"
+		<< "Wins: " << result.wins << " (" << 100.0 * result.wins / games << "%)\n"
+		<< "Losses: " << result.losses << " (" << 100.0 * result.losses / games << "%)\n"
+		<< "Timeouts: " << result.timeouts << " (" << 100.0 * result.timeouts / games << "%)\n";
+	if (result.wins > 0){
+		std::cout << "Average turns to win: " << (double)result.winTurns / result.wins << "\n"
+			<< "Turns to win:\n";
+		for (int b = 0; b < static_cast<int>(result.winHistogram.size()); b++){
+			if (result.winHistogram[b] > 0){
+				std::cout << "  " << b * result.binWidth << "-" << (b + 1) * result.binWidth - 1 << ": " << result.winHistogram[b] << "\n";
+			}
+		}
+	}
+	if (options.checkInventory){
+		std::cout << "Inventory mismatches: " << result.inventoryMismatches << "\n";
+	}
+	std::cout << std::flush;
+	return (options.checkInventory && result.inventoryMismatches > 0) ? 1 : 0;
+}
@@ -0,0 +1,352 @@
+#include "Simulator.h"
+#include "SymbolTable.h"
+#include "WorkStealingPool.h"
+#include "OutputSink.h"
+#include <algorithm> // For std::fill
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+/*
+ * Simulator plays many games with a computer player strategy,
+ * in parallel, and adds up how they turned out.
+ */
+
+// Most the player can carry and still move, in hundredths of a pound (Game::go refuses to move above this)
+static const int CARRY_LIMIT = 30 * WEIGHT_UNITS_PER_POUND;
+// Coins the sellers charge for each item (Game::buy)
+static const int SHOP_PRICE = 25;
+// How many rooms the forager searches for food, sellers, or people to rob before giving up
+static const int SEARCH_LIMIT = 4096;
+// Names of the NPCs the forager treats specially
+static const int VENDING_MACHINE = SymbolTable::global().intern("Vending machine");
+static const int EMPLOYEE = SymbolTable::global().intern("Employee");
+static const int ELF = SymbolTable::global().intern("Elf");
+
+// For each location, the direction of the first step on the shortest path to the Elf.
+// Found with a breadth-first search from the Elf over the edges in reverse.
+static std::vector<int> paths_to_elf(const World& world){
+	const WorldGraph& graph = world.graph;
+	int count = world.locations.size();
+	// Reverse edges: for each location, the (location, direction) pairs that lead into it
+	std::vector<std::vector<std::pair<int, int>>> incoming(count);
+	for (int l = 0; l < count; l++){
+		for (int e = graph.edges_begin(l); e < graph.edges_end(l); e++){
+			incoming[graph.edge_target(e)].push_back({l, graph.edge_direction(e)});
+		}
+	}
+	std::vector<int> towardElf(count, -1);
+	std::vector<bool> reached(count, false);
+	std::deque<int> queue;
+	reached[world.elfLocation] = true;
+	queue.push_back(world.elfLocation);
+	while (!queue.empty()){
+		int location = queue.front();
+		queue.pop_front();
+		for (const std::pair<int, int>& from : incoming[location]){
+			if (!reached[from.first]){
+				reached[from.first] = true;
+				towardElf[from.first] = from.second;
+				queue.push_back(from.first);
+			}
+		}
+	}
+	return towardElf;
+}
+
+// Build a command of the form "<verb> <name of symbol>"
+static void make_command(std::string& command, const char* verb, int nameId){
+	command = verb;
+	command += ' ';
+	command += SymbolTable::global().name(nameId);
+}
+
+// What nearest keeps from one search to the next, so a search only touches the rooms it reaches instead of
+// clearing a list as long as the world. A room's first step only counts when its mark is the current search's.
+struct NearestSearch{
+	std::vector<int> firstStep; // Direction of the first step to each room reached
+	std::vector<unsigned> mark; // Search each room was last reached in
+	unsigned current = 0; // The running search's mark; 0 is never one, so it marks rooms no search reached
+	std::vector<int> queue; // Rooms reached, in the order they're searched
+};
+
+// The direction of the first step towards the nearest other room where found(room) is true, or -1.
+// Breadth-first search from the current location.
+template <typename Found>
+static int nearest(const WorldGraph& graph, int here, Found found){
+	thread_local NearestSearch search; // One per thread, since games are simulated in parallel
+	if (static_cast<int>(search.mark.size()) < graph.location_count()){
+		search.firstStep.resize(graph.location_count());
+		search.mark.resize(graph.location_count(), 0);
+	}
+	if (++search.current == 0){ // The marks wrapped around, so old ones could be mistaken for this search's
+		std::fill(search.mark.begin(), search.mark.end(), 0);
+		search.current = 1;
+	}
+	auto reach = [](int location, int step){ // search is thread_local, so it needs no capture
+		search.mark[location] = search.current;
+		search.firstStep[location] = step;
+		search.queue.push_back(location);
+	};
+	search.queue.clear();
+	reach(here, -1);
+	for (int next = 0; next < static_cast<int>(search.queue.size()) && next < SEARCH_LIMIT; next++){
+		int location = search.queue[next];
+		if (location != here && found(location)){
+			return search.firstStep[location];
+		}
+		for (int e = graph.edges_begin(location); e < graph.edges_end(location); e++){
+			int target = graph.edge_target(e);
+			if (search.mark[target] != search.current){
+				reach(target, (location == here) ? graph.edge_direction(e) : search.firstStep[location]);
+			}
+		}
+	}
+	return -1;
+}
+
+// Pick the forager's next command
+bool Simulator::forager_command(Game& game, const SimulationOptions& options, const std::vector<int>& towardElf, std::string& command){
+	int here = game.currentLocation;
+	const WorldDefinition& world = *game.world;
+	const WorldState& state = *game.state; // Read only, so nothing shared with other games is copied
+	const Location& room = world.locations[here];
+	// The inventory keeps these totals, so there's nothing to add up
+	const ItemStore& store = world.items;
+	const std::vector<ItemHandle>& carried = game.inventory.items();
+	int carriedCalories = game.inventory.calories();
+	int carriedWeight = game.inventory.weight_units();
+	// Feed the Elf one food item at a time
+	if (here == world.elfLocation){
+		for (ItemHandle item : carried){
+			if (store.calories(item) > 0){
+				make_command(command, "give", store.name_id(item));
+				return true;
+			}
+		}
+	}
+	// Too heavy to move; drop something
+	if (carriedWeight > CARRY_LIMIT && !carried.empty()){
+		make_command(command, "give", store.name_id(carried.back()));
+		return true;
+	}
+	int goal = game.winningCalories;
+	if (options.lootCalories > 0 && options.lootCalories < goal){
+		goal = options.lootCalories;
+	}
+	// Head back to the Elf once carrying enough
+	if (carriedCalories >= goal && towardElf[here] >= 0){
+		make_command(command, "go", towardElf[here]);
+		return true;
+	}
+	// Take any food here that fits in the backpack
+	auto fits = [carriedWeight, &store](ItemHandle item){
+		return store.calories(item) > 0 && carriedWeight + store.weight_units(item) <= CARRY_LIMIT;
+	};
+	for (ItemHandle item : state.items(here)){
+		if (fits(item)){
+			make_command(command, "take", store.name_id(item));
+			return true;
+		}
+	}
+	// Otherwise walk towards the nearest room with food that fits
+	int step = nearest(world.graph, here, [&fits, &state](int location){
+		for (ItemHandle item : state.items(location)){
+			if (fits(item)){
+				return true;
+			}
+		}
+		return false;
+	});
+	if (step >= 0){
+		make_command(command, "go", step);
+		return true;
+	}
+	// No free food left; buy food with coins, if there's any left to buy
+	auto sells = [](const NPC& npc){
+		return npc.nameId == VENDING_MACHINE || npc.nameId == EMPLOYEE;
+	};
+	auto hasSeller = [&sells, &world](int location){
+		for (const NPC& npc : world.locations[location].locationNPCs){
+			if (sells(npc)){
+				return true;
+			}
+		}
+		return false;
+	};
+	bool forSale = state.shopItemsSold < world.shopCount; // Whether there's anything left to buy
+	if (game.coins >= SHOP_PRICE && forSale && carriedWeight + store.weight_units(world.shopStart + state.shopItemsSold) <= CARRY_LIMIT){
+		for (const NPC& npc : room.locationNPCs){
+			if (sells(npc)){
+				make_command(command, "buy", npc.nameId);
+				return true;
+			}
+		}
+		step = nearest(world.graph, here, hasSeller);
+		if (step >= 0){
+			make_command(command, "go", step);
+			return true;
+		}
+	}
+	// Or steal coins to buy it with, from anyone not robbed yet (except the Elf and the sellers)
+	if (forSale){
+		// The n-th NPC of a location, if they can be robbed
+		auto robbable = [&sells, &world, &state](int location, int n){
+			const NPC& npc = world.locations[location].locationNPCs[n];
+			return !state.npcs[world.npc_number(location, n)].robbed && npc.nameId != ELF && !sells(npc);
+		};
+		for (int n = 0; n < static_cast<int>(room.locationNPCs.size()); n++){
+			if (robbable(here, n)){
+				make_command(command, "steal", room.locationNPCs[n].nameId);
+				return true;
+			}
+		}
+		step = nearest(world.graph, here, [&robbable, &world](int location){
+			for (int n = 0; n < static_cast<int>(world.locations[location].locationNPCs.size()); n++){
+				if (robbable(location, n)){
+					return true;
+				}
+			}
+			return false;
+		});
+		if (step >= 0){
+			make_command(command, "go", step);
+			return true;
+		}
+	}
+	// Nothing left to find; bring what there is to the Elf, or give up
+	if (carriedCalories > 0 && towardElf[here] >= 0){
+		make_command(command, "go", towardElf[here]);
+		return true;
+	}
+	return false;
+}
+
+// Pick a random command with a random target
+void Simulator::random_command(Game& game, Random& agentRng, std::string& command){
+	const Location& room = game.world->locations[game.currentLocation];
+	const std::vector<ItemHandle>& roomItems = std::as_const(*game.state).items(game.currentLocation);
+	const ItemStore& store = game.world->items;
+	const WorldGraph& graph = game.world->graph;
+	switch (agentRng.below(7)){
+		case 0: {
+			int edges = graph.edges_end(game.currentLocation) - graph.edges_begin(game.currentLocation);
+			if (edges > 0){
+				make_command(command, "go", graph.edge_direction(graph.edges_begin(game.currentLocation) + agentRng.below(edges)));
+				return;
+			}
+			break;
+		}
+		case 1:
+			if (!roomItems.empty()){
+				make_command(command, "take", store.name_id(roomItems[agentRng.below(roomItems.size())]));
+				return;
+			}
+			break;
+		case 2:
+			if (game.inventory.size() > 0){
+				make_command(command, "give", store.name_id(game.inventory.items()[agentRng.below(game.inventory.size())]));
+				return;
+			}
+			break;
+		case 3:
+		case 4:
+		case 5:
+			if (!room.locationNPCs.empty()){
+				static const char* verbs[] = {"talk", "steal", "buy"};
+				make_command(command, verbs[agentRng.below(3)], room.locationNPCs[agentRng.below(room.locationNPCs.size())].nameId);
+				return;
+			}
+			break;
+	}
+	command = "look";
+}
+
+// Play one game until it ends or runs out of turns
+int Simulator::play_game(Game& game, const SimulationOptions& options, const std::vector<int>& towardElf, std::uint64_t agentSeed, int& mismatches){
+	Random agentRng(agentSeed);
+	std::string command;
+	int turns = 0;
+	while (game.inProgress && turns < options.maxTurns){
+		if (options.strategy == "forager"){
+			if (!forager_command(game, options, towardElf, command)){
+				break;
+			}
+		} else {
+			random_command(game, agentRng, command);
+		}
+		game.run_command(command);
+		turns++;
+		// Check the inventory's running totals against adding them up from scratch
+		if (options.checkInventory && !game.inventory.matches(game.world->items)){
+			mismatches++;
+		}
+	}
+	return turns;
+}
+
+// Play all the games across the thread pool and add up the results
+SimulationResult Simulator::run(const World& world, const SimulationOptions& options){
+	if (options.strategy != "forager" && options.strategy != "random"){
+		throw std::invalid_argument("Unknown strategy: " + options.strategy);
+	}
+	std::vector<int> towardElf = paths_to_elf(world);
+	// One definition of the world, shared by every game
+	std::shared_ptr<const WorldDefinition> definition = std::make_shared<const WorldDefinition>(world);
+	WorkStealingPool pool(options.threads);
+
+	// Shared totals, added to by every thread without locks
+	const int binWidth = options.maxTurns >= 100 ? options.maxTurns / 100 : 1;
+	const int binCount = options.maxTurns / binWidth + 1;
+	std::atomic<std::uint64_t> wins(0);
+	std::atomic<std::uint64_t> losses(0);
+	std::atomic<std::uint64_t> timeouts(0);
+	std::atomic<std::uint64_t> winTurns(0);
+	std::atomic<std::uint64_t> inventoryMismatches(0);
+	std::unique_ptr<std::atomic<std::uint64_t>[]> histogram(new std::atomic<std::uint64_t>[binCount]);
+	for (int b = 0; b < binCount; b++){
+		histogram[b].store(0);
+	}
+	// Each thread gets a sink to give its games, which drops everything written to it
+	std::vector<std::unique_ptr<NullSink>> discard;
+	for (int t = 0; t < pool.threads(); t++){
+		discard.emplace_back(new NullSink());
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	pool.run(options.games, [&](std::uint64_t index, int thread){
+		Game game(definition, options.seed + index, discard[thread]->stream());
+		int mismatches = 0;
+		int turns = play_game(game, options, towardElf, ~(options.seed + index), mismatches);
+		if (mismatches > 0){
+			inventoryMismatches.fetch_add(mismatches, std::memory_order_relaxed);
+		}
+		if (game.inProgress){
+			timeouts.fetch_add(1, std::memory_order_relaxed);
+		} else if (game.winningCalories <= 0){
+			wins.fetch_add(1, std::memory_order_relaxed);
+			winTurns.fetch_add(turns, std::memory_order_relaxed);
+			histogram[turns / binWidth].fetch_add(1, std::memory_order_relaxed);
+		} else {
+			losses.fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+	auto stop = std::chrono::steady_clock::now();
+
+	SimulationResult result;
+	result.wins = wins.load();
+	result.losses = losses.load();
+	result.timeouts = timeouts.load();
+	result.winTurns = winTurns.load();
+	result.inventoryMismatches = inventoryMismatches.load();
+	result.binWidth = binWidth;
+	for (int b = 0; b < binCount; b++){
+		result.winHistogram.push_back(histogram[b].load());
+	}
+	result.seconds = std::chrono::duration<double>(stop - start).count();
+	return result;
+}
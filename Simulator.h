@@ -0,0 +1,89 @@
+#ifndef __SIMULATOR_H__ // INCLUDE GUARD
+#define __SIMULATOR_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "World.h"
+#include "Game.h"
+
+/*
+ * Header file for Simulator.cpp
+ * Simulator plays many independent games with a scripted strategy
+ * (a computer player) to estimate how often the strategy wins and how
+ * many turns it takes. Every game gets its own Game, with its own seed,
+ * all sharing one WorldDefinition of the world and writing their output to NullSinks.
+ * The games run across all CPU cores on a WorkStealingPool, and the
+ * results are added into shared atomic counters, without locks.
+ * The strategies enter commands as text through Game::run_command, the
+ * same way a player would.
+ *
+ * Strategies:
+ *  random   each turn, does a random command (go, take, give, talk, steal, buy, look)
+ *           on a random target
+ *  forager  takes food it can carry, walks to the nearest room with food, and goes
+ *           back to feed the Elf once it carries lootCalories (or everything still needed).
+ *           Once the free food runs out, it steals coins and buys food from the sellers.
+ */
+
+// Settings for a simulation run
+struct SimulationOptions{
+	std::string strategy = "forager"; // random or forager
+	std::uint64_t games = 100000; // Number of games to play
+	int threads = 0; // Number of threads to use, 0 for one per CPU core
+	std::uint64_t seed = 1; // Game n uses seed + n, so a run can be repeated
+	int maxTurns = 1000; // Games not over after this many turns count as timeouts
+	int lootCalories = 0; // Forager: calories to carry before feeding the Elf, 0 for all that's still needed
+	bool checkInventory = false; // After every turn, check the inventory's running totals against adding them up again
+};
+
+// Totals over all the games in a simulation run
+struct SimulationResult{
+	std::uint64_t wins = 0;
+	std::uint64_t losses = 0;
+	std::uint64_t timeouts = 0; // Games still going at maxTurns, or where the strategy had nothing left to do
+	std::uint64_t winTurns = 0; // Total turns taken over all won games
+	std::uint64_t inventoryMismatches = 0; // Turns where the inventory's totals were wrong (only with checkInventory)
+	int binWidth = 1; // Number of turns each histogram bin covers
+	std::vector<std::uint64_t> winHistogram; // Bin b counts the wins that took b * binWidth to (b + 1) * binWidth - 1 turns
+	double seconds = 0; // Wall clock time of the run
+};
+
+class Simulator{
+	private:
+		/*
+		 * play_game plays one game to the end (or maxTurns) with the chosen strategy.
+		 *
+		 * Args:
+		 * game, the game to play
+		 * options, the simulation settings
+		 * towardElf, for each location, the direction (symbol ID) of the next step on
+		 * the shortest path to the Elf, or -1
+		 * agentSeed, the seed for the strategy's own random choices
+		 * mismatches, incremented for each turn the inventory totals were
+		 * wrong, when options.checkInventory is set
+		 *
+		 * Returns:
+		 * The number of turns played.
+		 */
+		static int play_game(Game& game, const SimulationOptions& options, const std::vector<int>& towardElf, std::uint64_t agentSeed, int& mismatches);
+		// Pick the forager's next command, or return false if it has nothing left to do
+		static bool forager_command(Game& game, const SimulationOptions& options, const std::vector<int>& towardElf, std::string& command);
+		// Pick a random command
+		static void random_command(Game& game, Random& agentRng, std::string& command);
+	public:
+		/*
+		 * run plays options.games games in the given world and adds up the results.
+		 * Throws an invalid_argument exception if the strategy isn't known.
+		 *
+		 * Args:
+		 * world, the world every game starts from
+		 * options, the simulation settings
+		 *
+		 * Returns:
+		 * The totals over all games.
+		 */
+		static SimulationResult run(const World& world, const SimulationOptions& options);
+};
+
+#endif
@@ -0,0 +1,294 @@
+#include "Snapshot.h"
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+/*
+ * Snapshot saves a Game's state as a header and a few
+ * flat arrays, and restores it into a game of the same world.
+ */
+
+// Layout of a snapshot. Every field is 4 bytes, like a compiled world (see WorldLoader.cpp).
+static const char SNAPSHOT_MAGIC[4] = {'G', 'V', 'Z', 'S'};
+
+struct SnapshotHeader{
+	char magic[4];
+	uint32_t version;
+	uint32_t headerSize;
+	// Checked against the game being restored into, so a snapshot only goes back into its own world
+	uint32_t locationCount;
+	uint32_t npcCount;
+	uint32_t worldItemCount; // Items placed in the world's locations; the shop items come after them
+	uint32_t shopItemCount;
+	// The state
+	uint32_t shopItemsSold;
+	uint32_t placedItemCount; // Items in all the locations together
+	uint32_t inventoryCount;
+	int32_t currentLocation;
+	int32_t winningCalories;
+	int32_t coins;
+	uint32_t inProgress;
+	uint32_t rngState[8]; // The generator's four 64 bit words, low half first
+};
+
+// Words in a bitset of count bits
+static uint32_t bitset_words(uint32_t count){
+	return (count + 31) / 32;
+}
+
+// Appends arrays to the snapshot buffer, which is sized once up front
+class SnapshotWriter{
+	private:
+		char* next;
+	public:
+		SnapshotWriter(char* start) : next(start){}
+		void write(const void* data, std::size_t size){
+			std::memcpy(next, data, size);
+			next += size;
+		}
+		// Point at the next count words, to be filled in place
+		uint32_t* words(std::size_t count){
+			uint32_t* start = reinterpret_cast<uint32_t*>(next);
+			next += count * sizeof(uint32_t);
+			return start;
+		}
+};
+
+// Save the game's state into the buffer
+void Snapshot::save(const Game& game, std::string& bytes){
+	if (game.shared){
+		throw std::invalid_argument("Games in a shared world can't be saved.");
+	}
+	const WorldDefinition& world = *game.world;
+	const WorldState& state = *game.state;
+	SnapshotHeader header{};
+	std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.version = VERSION;
+	header.headerSize = sizeof(SnapshotHeader);
+	header.locationCount = world.location_count();
+	header.npcCount = world.npc_count();
+	for (const RoomState& room : state.rooms){
+		header.placedItemCount += room.items.size();
+	}
+	header.worldItemCount = world.shopStart;
+	header.shopItemCount = world.shopCount;
+	header.shopItemsSold = state.shopItemsSold;
+	header.inventoryCount = game.inventory.handles.size();
+	header.currentLocation = game.currentLocation;
+	header.winningCalories = game.winningCalories;
+	header.coins = game.coins;
+	header.inProgress = game.inProgress;
+	for (int w = 0; w < 4; w++){
+		header.rngState[2 * w] = static_cast<uint32_t>(game.rng.state[w]);
+		header.rngState[2 * w + 1] = static_cast<uint32_t>(game.rng.state[w] >> 32);
+	}
+
+	uint32_t visitedWords = bitset_words(header.locationCount);
+	uint32_t robbedWords = bitset_words(header.npcCount);
+	std::size_t words = visitedWords + robbedWords + header.npcCount + header.locationCount + header.placedItemCount + header.inventoryCount;
+	bytes.resize(sizeof(SnapshotHeader) + words * sizeof(uint32_t));
+	SnapshotWriter writer(bytes.data());
+	writer.write(&header, sizeof(header));
+
+	uint32_t* visited = writer.words(visitedWords);
+	uint32_t* robbed = writer.words(robbedWords);
+	std::memset(visited, 0, (visitedWords + robbedWords) * sizeof(uint32_t));
+	int32_t* messageNums = reinterpret_cast<int32_t*>(writer.words(header.npcCount));
+	uint32_t* itemCounts = writer.words(header.locationCount);
+	uint32_t n = 0;
+	for (const NPCState& npc : state.npcs){
+		robbed[n / 32] |= static_cast<uint32_t>(npc.robbed) << (n % 32);
+		messageNums[n] = npc.messageNum;
+		n++;
+	}
+	uint32_t l = 0;
+	for (const RoomState& room : state.rooms){
+		visited[l / 32] |= static_cast<uint32_t>(room.visited) << (l % 32);
+		itemCounts[l] = room.items.size();
+		l++;
+	}
+	for (const RoomState& room : state.rooms){
+		writer.write(room.items.data(), room.items.size() * sizeof(ItemHandle));
+	}
+	writer.write(game.inventory.handles.data(), game.inventory.handles.size() * sizeof(ItemHandle));
+}
+
+// Check the whole snapshot against the game, then put the game in the saved state
+void Snapshot::restore(Game& game, std::string_view bytes){
+	if (game.shared){
+		throw std::invalid_argument("Games in a shared world can't be restored.");
+	}
+	const WorldDefinition& world = *game.world;
+	if (bytes.size() < sizeof(SnapshotHeader)){
+		throw std::invalid_argument("Snapshot is too small.");
+	}
+	SnapshotHeader header;
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0){
+		throw std::invalid_argument("Not a snapshot.");
+	}
+	if (header.version != VERSION || header.headerSize != sizeof(SnapshotHeader)){
+		throw std::invalid_argument("Snapshot is version " + std::to_string(header.version) + ", expected " + std::to_string(VERSION) + ".");
+	}
+	if (header.locationCount != static_cast<uint32_t>(world.location_count()) || header.npcCount != static_cast<uint32_t>(world.npc_count())
+		|| header.worldItemCount != static_cast<uint32_t>(world.shopStart) || header.shopItemCount != static_cast<uint32_t>(world.shopCount)){
+		throw std::invalid_argument("Snapshot is of a different world.");
+	}
+	// Shop items not sold yet can't be in any list
+	uint32_t itemCount = header.worldItemCount + header.shopItemsSold;
+	if (header.shopItemsSold > header.shopItemCount || header.placedItemCount > itemCount || header.inventoryCount > itemCount - header.placedItemCount
+		|| header.currentLocation < 0 || header.currentLocation >= static_cast<int32_t>(header.locationCount) || header.inProgress > 1){
+		throw std::invalid_argument("Snapshot is corrupt.");
+	}
+	uint32_t visitedWords = bitset_words(header.locationCount);
+	uint32_t robbedWords = bitset_words(header.npcCount);
+	std::size_t words = static_cast<std::size_t>(visitedWords) + robbedWords + header.npcCount + header.locationCount + header.placedItemCount + header.inventoryCount;
+	if (bytes.size() != sizeof(SnapshotHeader) + words * sizeof(uint32_t)){
+		throw std::invalid_argument("Snapshot is truncated or corrupt.");
+	}
+	// The arrays are copied out rather than pointed into, since the bytes may not be 4 byte aligned
+	std::vector<uint32_t> data(words);
+	std::memcpy(data.data(), bytes.data() + sizeof(SnapshotHeader), words * sizeof(uint32_t));
+	const uint32_t* visited = data.data();
+	const uint32_t* robbed = visited + visitedWords;
+	const int32_t* messageNums = reinterpret_cast<const int32_t*>(robbed + robbedWords);
+	const uint32_t* itemCounts = reinterpret_cast<const uint32_t*>(messageNums + header.npcCount);
+	const ItemHandle* placed = reinterpret_cast<const ItemHandle*>(itemCounts + header.locationCount);
+	const ItemHandle* carried = placed + header.placedItemCount;
+
+	// Every item can be in at most one list
+	uint64_t placedTotal = 0;
+	uint32_t n = 0;
+	for (uint32_t l = 0; l < header.locationCount; l++){
+		placedTotal += itemCounts[l];
+		for (const NPC& npc : world.locations[l].locationNPCs){
+			// An NPC without messages stays on message 0, the same as save writes for it
+			int32_t messageCount = npc.messages.empty() ? 1 : static_cast<int32_t>(npc.messages.size());
+			if (messageNums[n] < 0 || messageNums[n] >= messageCount){
+				throw std::invalid_argument("Snapshot has a bad message number.");
+			}
+			n++;
+		}
+	}
+	if (placedTotal != header.placedItemCount){
+		throw std::invalid_argument("Snapshot is corrupt.");
+	}
+	std::vector<bool> listed(itemCount);
+	for (uint32_t i = 0; i < header.placedItemCount + header.inventoryCount; i++){
+		ItemHandle item = placed[i];
+		if (item < 0 || static_cast<uint32_t>(item) >= itemCount || listed[item]){
+			throw std::invalid_argument("Snapshot has a bad item handle.");
+		}
+		listed[item] = true;
+	}
+
+	// The snapshot is good, so change the game. Only what differs is written, so restoring
+	// a game that shares its state with others (see CowArray.h) only copies what changed.
+	WorldState& state = *game.state;
+	const WorldState& current = state; // For reading without copying
+	CowArray<int, ITEM_LEAF_SIZE>& slots = state.slots.slots;
+	// Whether the saved items of a location differ from the ones it has
+	auto items_differ = [&current](int l, const ItemHandle* saved, uint32_t savedCount){
+		const std::vector<ItemHandle>& items = current.rooms[l].items;
+		return items.size() != savedCount || !std::equal(items.begin(), items.end(), saved);
+	};
+	// Take the items of every list that changes out of their slots, while their handles are still good.
+	// That includes any shop items sold since, which are in no list in the saved game.
+	const ItemHandle* next = placed;
+	for (uint32_t l = 0; l < header.locationCount; l++){
+		if (items_differ(l, next, itemCounts[l])){
+			for (ItemHandle item : current.rooms[l].items){
+				slots[item] = -1;
+			}
+		}
+		next += itemCounts[l];
+	}
+	for (ItemHandle item : game.inventory.handles){
+		slots[item] = -1;
+	}
+	state.shopItemsSold = header.shopItemsSold;
+
+	for (uint32_t l = 0; l < header.locationCount; l++){
+		bool visitedNow = (visited[l / 32] >> (l % 32)) & 1;
+		if (current.rooms[l].visited != visitedNow){
+			state.rooms[l].visited = visitedNow;
+			// Neighbors print this location's name once it's visited. Their look text only
+			// notices new visits by itself (see WorldState::render), so mark it out of date
+			for (int e = world.graph.incoming_begin(l); e < world.graph.incoming_end(l); e++){
+				state.rooms[world.graph.incoming_source(e)].lookDirty = true;
+			}
+		}
+		if (items_differ(l, placed, itemCounts[l])){
+			RoomState& room = state.rooms[l];
+			room.items.assign(placed, placed + itemCounts[l]);
+			room.lookDirty = true;
+			WorldState::rebuild_item_index(room, world.items);
+		}
+		placed += itemCounts[l];
+	}
+	for (n = 0; n < header.npcCount; n++){
+		bool robbedNow = (robbed[n / 32] >> (n % 32)) & 1;
+		const NPCState& npc = current.npcs[n];
+		if (npc.robbed != robbedNow || npc.messageNum != messageNums[n]){
+			NPCState& changed = state.npcs[n];
+			changed.robbed = robbedNow;
+			changed.messageNum = messageNums[n];
+		}
+	}
+	// Put back the slots of the items in the lists that changed (the rest are already right)
+	placed = carried - header.placedItemCount;
+	for (uint32_t l = 0; l < header.locationCount; l++){
+		for (uint32_t slot = 0; slot < itemCounts[l]; slot++){
+			if (std::as_const(slots)[placed[slot]] != static_cast<int>(slot)){
+				slots[placed[slot]] = slot;
+			}
+		}
+		placed += itemCounts[l];
+	}
+	Inventory& inventory = game.inventory;
+	inventory.handles.assign(carried, carried + header.inventoryCount);
+	inventory.weightUnits = 0;
+	inventory.calorieCount = 0;
+	inventory.edibleCount = 0;
+	for (int slot = 0; slot < static_cast<int>(inventory.handles.size()); slot++){
+		slots[inventory.handles[slot]] = slot;
+		inventory.count(world.items, inventory.handles[slot], 1);
+	}
+
+	game.currentLocation = header.currentLocation;
+	game.winningCalories = header.winningCalories;
+	game.coins = header.coins;
+	game.inProgress = header.inProgress;
+	for (int w = 0; w < 4; w++){
+		game.rng.state[w] = header.rngState[2 * w] | static_cast<std::uint64_t>(header.rngState[2 * w + 1]) << 32;
+	}
+}
+
+// Save to a buffer, then write it out in one go
+void Snapshot::save_file(const Game& game, const std::string& path){
+	std::string bytes;
+	save(game, bytes);
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(bytes.data(), bytes.size());
+	if (!file){
+		throw std::invalid_argument("Could not write snapshot file: " + path);
+	}
+}
+
+// Read the whole file in one go, then restore from it
+void Snapshot::restore_file(Game& game, const std::string& path){
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file){
+		throw std::invalid_argument("Could not open snapshot file: " + path);
+	}
+	std::string bytes(static_cast<std::size_t>(file.tellg()), '\0');
+	file.seekg(0);
+	file.read(bytes.data(), bytes.size());
+	if (!file){
+		throw std::invalid_argument("Could not read snapshot file: " + path);
+	}
+	restore(game, bytes);
+}
@@ -0,0 +1,84 @@
+#ifndef __SNAPSHOT_H__ // INCLUDE GUARD
+#define __SNAPSHOT_H__
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "Game.h"
+
+/*
+ * Header file for Snapshot.cpp
+ * Snapshot saves everything about a Game that changes while it's
+ * played (the player's inventory, coins, calories left to win, and
+ * location, each location's items and visited flag, each NPC's message
+ * number and robbed flag, the shop items sold, and the random number
+ * generator) and restores it into another Game made from the same world.
+ * That's the game's WorldState plus the player; the WorldDefinition
+ * (names, descriptions, exits) isn't saved, since it never changes, so
+ * a snapshot is only a few bytes per location.
+ *
+ * A snapshot is a versioned header followed by flat arrays of 4 byte
+ * fields, so saving is one resize and a memcpy per array, and restoring
+ * reads the arrays straight back in:
+ *   header
+ *   visited flags, a bitset of locationCount bits in 32 bit words
+ *   robbed flags, a bitset of npcCount bits (NPCs in location order)
+ *   message numbers, one per NPC
+ *   item counts, one per location
+ *   item handles of every location, one location after another
+ *   item handles of the inventory
+ */
+
+class Snapshot{
+	public:
+		// Snapshots of other versions can't be restored
+		static const std::uint32_t VERSION = 1;
+		/*
+		 * save writes a game's state into a buffer, replacing what was in it.
+		 * The buffer's memory is reused, so saving again doesn't allocate.
+		 * Throws an invalid_argument exception for a game in a SharedWorld,
+		 * whose state other players may be changing.
+		 *
+		 * Args:
+		 * game, the game to save
+		 * bytes, the buffer to write the snapshot into
+		 */
+		static void save(const Game& game, std::string& bytes);
+		/*
+		 * restore puts a game back in the state a snapshot was saved in.
+		 * The game must have been made from the same world as the saved
+		 * game (it can be one that has been played since, or a new one).
+		 * Only what differs from the snapshot is written, so restoring
+		 * doesn't copy the parts of the state the game shares (see CowArray.h).
+		 * Throws an invalid_argument exception if the snapshot isn't a
+		 * valid snapshot of the current version for the game's world,
+		 * in which case the game is left as it was, or for a game in a
+		 * SharedWorld, which would change every player's state.
+		 *
+		 * Args:
+		 * game, the game to restore into
+		 * bytes, the snapshot
+		 */
+		static void restore(Game& game, std::string_view bytes);
+		/*
+		 * save_file saves a game's state to a file in a single write.
+		 * Throws an invalid_argument exception if the file can't be written.
+		 *
+		 * Args:
+		 * game, the game to save
+		 * path, the path of the file to write
+		 */
+		static void save_file(const Game& game, const std::string& path);
+		/*
+		 * restore_file restores a game from a snapshot file (see restore).
+		 * Throws an invalid_argument exception if the file can't be read
+		 * or isn't a valid snapshot for the game's world.
+		 *
+		 * Args:
+		 * game, the game to restore into
+		 * path, the path of the snapshot file
+		 */
+		static void restore_file(Game& game, const std::string& path);
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "SymbolTable.h"
+#include <mutex>
+#include <stdexcept>
+
+/*
+ * SymbolTable maps names to stable integer IDs and back.
+ * Includes the global table, and functions to intern a name,
+ * look up a name's ID (exactly or loosely), and get the name of an ID.
+ */
+
+// The table shared by the whole program. Made on first use, so it is
+// ready even when called while other globals are being set up.
+SymbolTable& SymbolTable::global(){
+	static SymbolTable table;
+	return table;
+}
+
+// Run a read of the table: under the shared lock while names can still be added, and without it once frozen.
+// The acquire load pairs with freeze's release store, so every name added before the freeze is seen.
+template <typename Read>
+static auto read_table(const std::atomic<bool>& frozen, std::shared_mutex& lock, Read read){
+	if (frozen.load(std::memory_order_acquire)){
+		return read();
+	}
+	std::shared_lock<std::shared_mutex> reading(lock);
+	return read();
+}
+
+// Get the ID of a name, adding it if it's new
+int SymbolTable::intern(std::string_view name){
+	int existing = lookup(name);
+	if (existing >= 0){
+		return existing;
+	}
+	std::unique_lock<std::shared_mutex> writing(lock);
+	// Check again, another thread may have added it (or frozen the table) while the lock was released
+	auto it = ids.find(name);
+	if (it != ids.end()){
+		return it->second;
+	}
+	if (frozen.load(std::memory_order_relaxed)){
+		throw std::invalid_argument("Can't add the name " + std::string(name) + " once the symbol table is frozen.");
+	}
+	int id = names.size();
+	names.emplace_back(name);
+	ids.emplace(names.back(), id);
+	trie.insert(name, id);
+	return id;
+}
+
+// Get the ID of a name, or -1 if it was never interned
+int SymbolTable::lookup(std::string_view name) const{
+	return read_table(frozen, lock, [&](){
+		auto it = ids.find(name);
+		return (it == ids.end()) ? -1 : it->second;
+	});
+}
+
+// Get the name of an ID
+const std::string& SymbolTable::name(int id) const{
+	return *read_table(frozen, lock, [&](){
+		return &names[id];
+	});
+}
+
+// Find loose matches in the trie
+bool SymbolTable::matches(std::string_view text, NameTrie::Match kind, std::vector<int>& ids, int limit) const{
+	return read_table(frozen, lock, [&](){
+		return trie.find(text, kind, ids, limit);
+	});
+}
+
+int SymbolTable::size() const{
+	return read_table(frozen, lock, [&](){
+		return static_cast<int>(names.size());
+	});
+}
+
+// Set the flag under the lock, so no intern is part way through adding a name when reads stop taking it
+void SymbolTable::freeze(){
+	std::unique_lock<std::shared_mutex> writing(lock);
+	frozen.store(true, std::memory_order_release);
+}
+
+bool SymbolTable::is_frozen() const{
+	return frozen.load(std::memory_order_acquire);
+}
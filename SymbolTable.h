@@ -0,0 +1,109 @@
+#ifndef __SYMBOLTABLE_H__ // INCLUDE GUARD
+#define __SYMBOLTABLE_H__
+
+#include <string>
+#include <string_view>
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <vector>
+#include "NameTrie.h"
+
+/*
+ * Header file for SymbolTable.cpp
+ * SymbolTable interns names: each different name (of an item, NPC,
+ * location, or direction) is stored once and given a stable integer ID.
+ * Items, NPCs, and Locations hold the ID of their name instead of their
+ * own copy of it, so matching a command's target against everything in
+ * a room is an integer compare once the target has been looked up.
+ * Every name is also kept in a NameTrie, so what the player types can be
+ * matched loosely (any capitalization, a prefix, or a typo; see matches).
+ * There is one global table, shared by every world and game; it is safe
+ * to use from multiple threads.
+ *
+ * Names are only added while worlds are being built, so once they are
+ * loaded the table can be frozen (see freeze). Until then every lookup
+ * shares a lock with intern. Once it's frozen nothing can change the
+ * table, so lookups read it without any lock, and many threads playing
+ * at once (ex. a ShardRuntime's shards) never touch a shared cache line
+ * to look up a name. Only intern still takes the lock.
+ */
+
+class SymbolTable{
+	private:
+		mutable std::shared_mutex lock; // Taken by intern, and shared by lookups until the table is frozen
+		std::atomic<bool> frozen{false}; // Set by freeze, after which the table never changes
+		std::deque<std::string> names; // ID -> name. A deque so the strings never move when it grows
+		std::unordered_map<std::string_view, int> ids; // Name -> ID. Keys point into names
+		NameTrie trie; // Folded names -> IDs, for loose matches
+	public:
+		/*
+		 * global gets the table shared by the whole program.
+		 *
+		 * Returns:
+		 * A reference to the global symbol table.
+		 */
+		static SymbolTable& global();
+		/*
+		 * intern gets the ID of a name, adding the name to the table
+		 * if it isn't in it yet. Throws an invalid_argument exception if
+		 * the name is new and the table is frozen.
+		 *
+		 * Args:
+		 * The name to intern.
+		 *
+		 * Returns:
+		 * The ID of the name.
+		 */
+		int intern(std::string_view name);
+		/*
+		 * lookup gets the ID of a name without adding it. Used to resolve
+		 * user input: a name that was never interned can't match anything.
+		 *
+		 * Args:
+		 * The name to look up.
+		 *
+		 * Returns:
+		 * The ID of the name, or -1 if it isn't in the table.
+		 */
+		int lookup(std::string_view name) const;
+		/*
+		 * name gets the name of an ID. The reference stays valid for
+		 * the rest of the program.
+		 *
+		 * Args:
+		 * An ID returned by intern.
+		 *
+		 * Returns:
+		 * The name with that ID.
+		 */
+		const std::string& name(int id) const;
+		/*
+		 * matches finds the IDs of the names that loosely match some text
+		 * (see NameTrie for the kinds of match).
+		 *
+		 * Args:
+		 * text, what the player typed
+		 * kind, the kind of match
+		 * ids, the list to add the IDs to
+		 * limit, most IDs to add
+		 *
+		 * Returns:
+		 * False if more than limit names matched.
+		 */
+		bool matches(std::string_view text, NameTrie::Match kind, std::vector<int>& ids, int limit) const;
+		// Number of names in the table
+		int size() const;
+		/*
+		 * freeze stops any more names being added, so lookups no longer
+		 * need the lock. Call it once the worlds are loaded, before many
+		 * threads start looking names up; interning a name that's already
+		 * in the table still works afterwards. It can't be undone.
+		 */
+		void freeze();
+		// Whether freeze has been called
+		bool is_frozen() const;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "TextArena.h"
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h> // For open()
+#include <sys/mman.h> // For mmap()
+#include <sys/stat.h> // For fstat()
+#include <unistd.h> // For close()
+
+/*
+ * TextArena stores a world's text in large blocks, and
+ * files mapped in whole, that are all freed together.
+ */
+
+// Size of the first block; each block after it is bigger than the last
+static const std::size_t FIRST_BLOCK_SIZE = 1 << 16;
+
+TextArena::TextArena() : memory(FIRST_BLOCK_SIZE), bytes(0){}
+
+TextArena::~TextArena(){
+	for (std::string_view mapping : mappings){
+		::munmap(const_cast<char*>(mapping.data()), mapping.size());
+	}
+}
+
+// Copy text into the arena and return a view of the copy
+std::string_view TextArena::copy(std::string_view text){
+	if (text.empty()){
+		return std::string_view();
+	}
+	char* stored = static_cast<char*>(memory.allocate(text.size(), 1));
+	std::memcpy(stored, text.data(), text.size());
+	bytes += text.size();
+	return std::string_view(stored, text.size());
+}
+
+// Map the file, and keep it mapped until the arena is destroyed
+std::string_view TextArena::map(const std::string& path){
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0){
+		throw std::invalid_argument("Could not open file: " + path);
+	}
+	void* data = MAP_FAILED;
+	std::size_t size = 0;
+	struct stat info;
+	if (::fstat(fd, &info) == 0 && info.st_size > 0){
+		size = info.st_size;
+		data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	::close(fd);
+	if (data == MAP_FAILED){
+		throw std::invalid_argument("Could not map file: " + path);
+	}
+	std::string_view mapping(static_cast<const char*>(data), size);
+	mappings.push_back(mapping);
+	return mapping;
+}
+
+std::size_t TextArena::size() const{
+	return bytes;
+}
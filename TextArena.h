@@ -0,0 +1,70 @@
+#ifndef __TEXTARENA_H__ // INCLUDE GUARD
+#define __TEXTARENA_H__
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Header file for TextArena.cpp
+ * TextArena owns the text of a world (descriptions and NPC messages).
+ * Text is copied into large blocks from a monotonic memory resource,
+ * one after the other, so storing a string is a pointer bump and a
+ * copy instead of a heap allocation, and the whole world's text is
+ * freed at once, block by block, when the arena is destroyed.
+ * Locations, Items, and NPCs only keep string_views of their text,
+ * so a World (and every Game made from it) shares its arena through a
+ * shared_ptr, which keeps the text alive for as long as anything
+ * might still point into it. Copying a world copies no text at all.
+ * Text that lives for the whole program, like the string literals in
+ * Game::create_world, doesn't need to be put in an arena.
+ * An arena can also hold whole files memory-mapped read-only (see map),
+ * so a compiled world's text is pointed to where it is in the file
+ * instead of being copied; the files stay mapped until the arena is
+ * destroyed, the same as its blocks.
+ * An arena is not safe to add to from several threads at once; worlds
+ * only add text while they are being built.
+ */
+
+class TextArena{
+	private:
+		std::pmr::monotonic_buffer_resource memory; // Hands out the blocks, and frees them all on destruction
+		std::size_t bytes; // Total bytes of text stored
+		std::vector<std::string_view> mappings; // Files mapped into the arena, unmapped on destruction
+	public:
+		// Constructor, makes an empty arena
+		TextArena();
+		// Destructor, unmaps the arena's files (the blocks are freed by memory)
+		~TextArena();
+		TextArena(const TextArena&) = delete;
+		TextArena& operator=(const TextArena&) = delete;
+		/*
+		 * copy stores a copy of some text in the arena.
+		 *
+		 * Args:
+		 * The text to copy.
+		 *
+		 * Returns:
+		 * A view of the copy, valid for as long as the arena exists.
+		 */
+		std::string_view copy(std::string_view text);
+		/*
+		 * map memory-maps a whole file read-only into the arena. Throws
+		 * an invalid_argument exception if the file can't be opened or
+		 * mapped (ex. it's empty). The file mustn't be cut short
+		 * while it's mapped, or reading the missing part crashes.
+		 *
+		 * Args:
+		 * The path of the file.
+		 *
+		 * Returns:
+		 * A view of the file's bytes, valid for as long as the arena exists.
+		 */
+		std::string_view map(const std::string& path);
+		// Total bytes of text stored in the arena, not counting mapped files
+		std::size_t size() const;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "WorkStealingPool.h"
+#include <thread>
+#include <algorithm>
+
+/*
+ * WorkStealingPool spreads numbered tasks across threads,
+ * with idle threads stealing half of the busiest thread's
+ * remaining tasks.
+ */
+
+// Number of tasks a thread takes off its own range at a time
+static const std::uint32_t TASK_BATCH = 4;
+
+static std::uint64_t pack(std::uint32_t begin, std::uint32_t end){
+	return (static_cast<std::uint64_t>(end) << 32) | begin;
+}
+
+static std::uint32_t range_begin(std::uint64_t bounds){
+	return static_cast<std::uint32_t>(bounds);
+}
+
+static std::uint32_t range_end(std::uint64_t bounds){
+	return static_cast<std::uint32_t>(bounds >> 32);
+}
+
+// Constructor, makes one range per thread
+WorkStealingPool::WorkStealingPool(int threads){
+	if (threads <= 0){
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threadCount = threads;
+	ranges.reset(new Range[threadCount]);
+	for (int t = 0; t < threadCount; t++){
+		ranges[t].bounds.store(0);
+	}
+}
+
+// Take a batch of tasks from the front of this thread's range
+bool WorkStealingPool::take(int thread, std::uint32_t batch, std::uint32_t& begin, std::uint32_t& end){
+	std::atomic<std::uint64_t>& bounds = ranges[thread].bounds;
+	std::uint64_t current = bounds.load(std::memory_order_acquire);
+	while (true){
+		std::uint32_t first = range_begin(current);
+		std::uint32_t last = range_end(current);
+		if (first >= last){
+			return false;
+		}
+		std::uint32_t next = std::min(last, first + batch);
+		// Fails (and reloads current) if a thief changed the range in the meantime
+		if (bounds.compare_exchange_weak(current, pack(next, last), std::memory_order_acq_rel)){
+			begin = first;
+			end = next;
+			return true;
+		}
+	}
+}
+
+// Steal the back half of the fullest range belonging to another thread
+bool WorkStealingPool::steal(int thread){
+	while (true){
+		// Find the thread with the most tasks left
+		int victim = -1;
+		std::uint64_t victimBounds = 0;
+		std::uint32_t most = 0;
+		for (int t = 0; t < threadCount; t++){
+			if (t == thread){
+				continue;
+			}
+			std::uint64_t bounds = ranges[t].bounds.load(std::memory_order_acquire);
+			std::uint32_t left = range_end(bounds) - std::min(range_begin(bounds), range_end(bounds));
+			if (left > most){
+				most = left;
+				victim = t;
+				victimBounds = bounds;
+			}
+		}
+		if (victim < 0){
+			return false; // Nothing left anywhere
+		}
+		std::uint32_t first = range_begin(victimBounds);
+		std::uint32_t last = range_end(victimBounds);
+		std::uint32_t middle = first + (last - first) / 2; // With one task left, this steals it
+		if (ranges[victim].bounds.compare_exchange_strong(victimBounds, pack(first, middle), std::memory_order_acq_rel)){
+			// This thread's range is empty, and thieves skip empty ranges, so a plain store is safe
+			ranges[thread].bounds.store(pack(middle, last), std::memory_order_release);
+			return true;
+		}
+		// The victim or another thief got there first; look again
+	}
+}
+
+// Run every task, returning once they're all done
+void WorkStealingPool::run(std::uint64_t count, const std::function<void(std::uint64_t index, int thread)>& task){
+	// Give each thread an even share to start with
+	for (int t = 0; t < threadCount; t++){
+		std::uint64_t first = count * t / threadCount;
+		std::uint64_t last = count * (t + 1) / threadCount;
+		ranges[t].bounds.store(pack(first, last), std::memory_order_relaxed);
+	}
+	auto work = [this, &task](int thread){
+		std::uint32_t begin;
+		std::uint32_t end;
+		do {
+			while (take(thread, TASK_BATCH, begin, end)){
+				for (std::uint32_t i = begin; i < end; i++){
+					task(i, thread);
+				}
+			}
+		} while (steal(thread));
+	};
+	// The calling thread is thread 0
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threadCount; t++){
+		workers.emplace_back(work, t);
+	}
+	work(0);
+	for (std::thread& worker : workers){
+		worker.join();
+	}
+}
+
+int WorkStealingPool::threads() const{
+	return threadCount;
+}
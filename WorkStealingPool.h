@@ -0,0 +1,58 @@
+#ifndef __WORKSTEALINGPOOL_H__ // INCLUDE GUARD
+#define __WORKSTEALINGPOOL_H__
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/*
+ * Header file for WorkStealingPool.cpp
+ * WorkStealingPool runs a numbered set of independent tasks
+ * (0 to count - 1) across a fixed number of threads.
+ * Each thread starts with an even share of the task numbers, kept as
+ * a [begin, end) range packed into one atomic word. A thread takes
+ * small batches off the front of its own range; when it runs out, it
+ * steals the back half of the range of whichever thread has the most
+ * left. Both sides update the range with compare-and-swap, so there
+ * are no locks, and threads that finish early (ex. their games were
+ * short) keep busy until all tasks are done.
+ */
+
+class WorkStealingPool{
+	private:
+		// A thread's remaining task range, on its own cache line so threads don't slow each other down
+		struct alignas(64) Range{
+			std::atomic<std::uint64_t> bounds; // begin in the low 32 bits, end in the high 32 bits
+		};
+		int threadCount;
+		std::unique_ptr<Range[]> ranges;
+		// Take up to batch tasks from the front of a thread's own range
+		bool take(int thread, std::uint32_t batch, std::uint32_t& begin, std::uint32_t& end);
+		// Steal the back half of the fullest other range into a thread's own range
+		bool steal(int thread);
+	public:
+		/*
+		 * Constructor
+		 *
+		 * Args:
+		 * The number of threads to run tasks on, or 0 to use one per CPU core.
+		 */
+		WorkStealingPool(int threads);
+		/*
+		 * run calls task(index, thread) for every index from 0 to
+		 * count - 1, spread across the pool's threads, and returns when
+		 * all of them are done. thread is the number (0 to threads - 1)
+		 * of the thread running the task, for keeping per-thread state.
+		 *
+		 * Args:
+		 * count, the number of tasks (less than 2^32)
+		 * task, the function to call for each task
+		 */
+		void run(std::uint64_t count, const std::function<void(std::uint64_t index, int thread)>& task);
+		// Number of threads tasks run on
+		int threads() const;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef __WORLD_H__ // INCLUDE GUARD
+#define __WORLD_H__
+
+#include <memory>
+#include <vector>
+#include "Item.h"
+#include "ItemStore.h"
+#include "Location.h"
+#include "WorldGraph.h"
+#include "TextArena.h"
+#include "CowArray.h"
+
+/*
+ * World holds everything needed to start a game in a world:
+ * the locations (with their NPCs, and handles to their Items), the
+ * store holding every item placed in a location, the items that can be
+ * bought from shopkeepers, the graph of directions between locations,
+ * and the indexes of the locations that have a special role in the game.
+ * The text of the descriptions and messages is owned by the world's
+ * TextArena, which copies of the world (and Games) share, and the
+ * locations, items, and graph are shared by copies until they change
+ * (see CowArray.h), so copying a World is cheap no matter its size.
+ * A World is made by Game::create_world for the built-in campus, or
+ * read from a file by WorldLoader, and played in through a
+ * WorldDefinition made from it (see WorldDefinition.h).
+ */
+
+struct World{
+	CowArray<Location> locations; // All locations in the world
+	ItemStore items; // Every item in the locations; the locations hold handles into it
+	std::shared_ptr<TextArena> text = std::make_shared<TextArena>(); // Owns the text the locations, items, and NPCs point to
+	std::vector<Item> shopItems; // Items that can be bought with the buy command
+	WorldGraph graph; // Directions between locations, by index into locations
+	int elfLocation = 0; // Index of the location where the Elf can be fed (win condition)
+	int securityLocation = 0; // Index of the location you're taken to when caught stealing
+};
+
+#endif
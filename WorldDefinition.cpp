@@ -0,0 +1,53 @@
+#include "WorldDefinition.h"
+#include <utility>
+
+/*
+ * WorldDefinition takes over a World, adds the shop items to
+ * its item store, numbers the NPCs, and builds the starting state.
+ */
+
+// Take over the world, then set up the starting state from where it put everything
+WorldDefinition::WorldDefinition(World world) : locations(std::move(world.locations)), items(std::move(world.items)),
+	graph(std::move(world.graph)), text(std::move(world.text)), elfLocation(world.elfLocation), securityLocation(world.securityLocation){
+	// Shop items go after the placed items, in no list until they're bought
+	shopStart = items.size();
+	shopCount = world.shopItems.size();
+	std::vector<ItemHandle> unplaced;
+	for (Item& item : world.shopItems){
+		items.add(std::move(item), unplaced);
+	}
+	// Number the NPCs in location order
+	firstNpcs.reserve(locations.size() + 1);
+	int npcCount = 0;
+	for (const Location& location : locations){
+		firstNpcs.push_back(npcCount);
+		npcCount += location.locationNPCs.size();
+	}
+	firstNpcs.push_back(npcCount);
+	// Games start with every item where the world put it, nothing visited, and nobody talked to or robbed
+	start.slots = ItemSlots(items.size());
+	start.npcs.resize(npcCount);
+	for (const Location& location : locations){
+		RoomState& room = start.rooms.emplace_back();
+		for (ItemHandle item : location.locationItems){
+			start.slots.place(item, room.items);
+		}
+		WorldState::rebuild_item_index(room, items);
+	}
+}
+
+int WorldDefinition::npc_number(int location, int npc) const{
+	return firstNpcs[location] + npc;
+}
+
+int WorldDefinition::location_count() const{
+	return locations.size();
+}
+
+int WorldDefinition::npc_count() const{
+	return firstNpcs.back();
+}
+
+const WorldState& WorldDefinition::start_state() const{
+	return start;
+}
@@ -0,0 +1,82 @@
+#ifndef __WORLDDEFINITION_H__ // INCLUDE GUARD
+#define __WORLDDEFINITION_H__
+
+#include <memory>
+#include <vector>
+#include "ItemStore.h"
+#include "Location.h"
+#include "WorldGraph.h"
+#include "TextArena.h"
+#include "World.h"
+#include "WorldState.h"
+#include "CowArray.h"
+
+/*
+ * Header file for WorldDefinition.cpp
+ * WorldDefinition is the part of a world that never changes while it's
+ * played: the locations with their names, descriptions, and NPCs (with
+ * their messages), every item's name, calories, weight, and description,
+ * the graph of directions, and the text all of it points into. It's made
+ * once from a World and then only read, so one definition is shared (through
+ * a std::shared_ptr<const WorldDefinition>) by every game played in that
+ * world, from any number of threads. Each game keeps what it changes
+ * in its own WorldState (see WorldState.h), so hosting many games at once
+ * costs one copy of the world's text, plus what each game has changed.
+ *
+ * The shop items are put in the item store after the items placed in
+ * locations, in the order they're sold, so buying one just moves its
+ * handle into the inventory. The NPCs are numbered in location order
+ * (every NPC of location 0, then location 1, ...), which is where each
+ * NPC's state is kept in a WorldState.
+ */
+
+class WorldDefinition{
+	private:
+		CowArray<Location> locations; // All locations in the world
+		ItemStore items; // The items placed in the locations, then the shop items
+		int shopStart; // Handle of the first shop item
+		int shopCount; // Number of shop items
+		std::vector<int> firstNpcs; // For each location, the number of its first NPC; one more at the end holds the NPC count
+		WorldGraph graph; // Directions between locations, by index into locations
+		std::shared_ptr<TextArena> text; // Owns the text the locations, items, and NPCs point to
+		int elfLocation; // Index of the location where the Elf can be fed (win condition)
+		int securityLocation; // Index of the location you're taken to when caught stealing
+		WorldState start; // The state every game starts in, shared by their states until they change it
+		// Friend of Game, WorldState, Simulator, Snapshot, SharedWorld, EventLog, and EventReplayer so they can read the definition without getters
+		friend class Game;
+		friend class WorldState;
+		friend class Simulator;
+		friend class Snapshot;
+		friend class SharedWorld;
+		friend class EventLog;
+		friend class EventReplayer;
+	public:
+		/*
+		 * Constructor that takes over a world (ex. from Game::create_world or
+		 * WorldLoader), and sets up the state games in it start in.
+		 *
+		 * Args:
+		 * The world. Copying a World is cheap (see World.h), so a world
+		 * can be kept after making a definition from a copy of it.
+		 */
+		WorldDefinition(World world);
+		/*
+		 * npc_number gets the number of an NPC among all the NPCs in the world.
+		 *
+		 * Args:
+		 * location, the index of the NPC's location
+		 * npc, the NPC's position in the location's NPCs
+		 *
+		 * Returns:
+		 * The NPC's number, its index in a WorldState's NPCs.
+		 */
+		int npc_number(int location, int npc) const;
+		// Number of locations in the world
+		int location_count() const;
+		// Number of NPCs in the world
+		int npc_count() const;
+		// The state every game in the world starts in
+		const WorldState& start_state() const;
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "WorldGenerator.h"
+#include "Random.h"
+#include <string>
+#include <stdexcept>
+#include <utility>
+
+/*
+ * WorldGenerator makes worlds of any size from a seed,
+ * out of lists of places, things, and people.
+ */
+
+// A kind of room: its name (after an adjective) and description
+struct Place{
+	const char* name;
+	const char* description;
+};
+
+// A kind of item that can be lying in a room
+struct Thing{
+	const char* name;
+	const char* description;
+	int calories;
+	float weight;
+};
+
+// A kind of NPC
+struct Person{
+	const char* name;
+	const char* description;
+};
+
+static const char* ADJECTIVES[] = {
+	"Dusty", "Quiet", "Crowded", "Narrow", "Sunny", "Cold", "Old", "New",
+	"Empty", "Noisy", "Dim", "Bright", "Long", "Tiny", "Messy", "Tidy"
+};
+
+static const Place PLACES[] = {
+	{"hallway", "A hallway lined with doors and bulletin boards."},
+	{"classroom", "Rows of desks face a whiteboard nobody erased."},
+	{"lecture hall", "Tiered seats slope down towards a projector screen."},
+	{"study room", "A table, a few chairs, and a window looking out over campus."},
+	{"lounge", "Couches and a coffee table covered in flyers."},
+	{"stairwell", "Concrete stairs echo with every step."},
+	{"courtyard", "A patch of grass between buildings, with a few benches."},
+	{"office", "A cluttered desk and shelves full of binders."},
+	{"lab", "Long benches with sinks and safety goggles hanging on hooks."},
+	{"cafe", "A counter, a menu board, and the smell of coffee."},
+	{"storage closet", "Boxes stacked to the ceiling. Watch your head."},
+	{"bike rack", "Bikes chained up in a long row under an awning."}
+};
+
+static const Thing THINGS[] = {
+	{"Apple", "A shiny red apple.", 20, 1.0f},
+	{"Bagel", "A slightly squashed bagel.", 30, 1.5f},
+	{"Pretzels", "A small bag of salted pretzels.", 25, 1.0f},
+	{"Banana", "A banana with a few brown spots.", 20, 1.0f},
+	{"Muffin", "A blueberry muffin in a paper wrapper.", 35, 1.5f},
+	{"Cold pizza", "A slice of pepperoni pizza from last night.", 45, 2.0f},
+	{"Trail mix", "Mostly raisins. Someone ate all the chocolate.", 30, 1.0f},
+	{"Cookie", "A big chocolate chip cookie.", 25, 0.5f},
+	{"Pencil", "A chewed up pencil.", 0, 0.5f},
+	{"Stapler", "A heavy red stapler.", 0, 2.0f},
+	{"Textbook", "An expensive textbook that was never opened.", 0, 6.0f},
+	{"Umbrella", "A broken umbrella.", 0, 3.0f},
+	{"Calculator", "A graphing calculator with no batteries.", 0, 1.0f},
+	{"Lanyard", "A lanyard with somebody's keys on it.", 0, 0.5f},
+	{"Traffic cone", "How did this get in here?", 0, 8.0f},
+	{"Poster", "A rolled up poster for a club meeting.", 0, 1.0f}
+};
+
+static const Person PEOPLE[] = {
+	{"Student", "A student with headphones in."},
+	{"Teaching assistant", "They're carrying a stack of ungraded papers."},
+	{"Tour guide", "They're walking backwards and talking about campus history."},
+	{"Custodian", "They're pushing a cart full of cleaning supplies."},
+	{"Barista", "They're wiping down a counter."},
+	{"Freshman", "They look lost."},
+	{"Senior", "They look tired."},
+	{"Dean", "They're on the phone and look very important."},
+	{"Goose", "A Canada goose. It stares at you."},
+	{"Lab partner", "They're waiting for someone who never showed up."},
+	{"Club president", "They're handing out flyers to anyone who walks by."},
+	{"Bus driver", "They're on their break."},
+	{"Librarian", "They're shelving books."},
+	{"Athlete", "They're stretching."},
+	{"Professor", "They're looking for their glasses, which are on their head."},
+	{"Squirrel", "A squirrel holding half a granola bar."}
+};
+
+static const char* MESSAGES[] = {
+	"Have you seen the Elf? I heard they're in the first room.",
+	"I'm so hungry. Everyone's so hungry today.",
+	"Don't go South, it just takes you back where you came from.",
+	"The Vending machines still work, if you have coins.",
+	"Leave me alone, I have an exam tomorrow.",
+	"Nice weather today, huh?",
+	"I think I'm lost.",
+	"Did you hear something?",
+	"Go Lakers!",
+	"I could really use a nap."
+};
+
+// Every direction a room can have an exit in. The first two are the ring.
+static const char* DIRECTIONS[] = {
+	"North", "South", "East", "West", "Up", "Down", "Northeast", "Northwest", "Southeast", "Southwest"
+};
+
+template <typename T, int N>
+static constexpr int count_of(const T (&)[N]){
+	return N;
+}
+
+// Which person NPC n in a room is, spread so neighboring rooms get different people
+static const Person& person_in(int room, int n){
+	return PEOPLE[(room * 5 + n) % count_of(PEOPLE)];
+}
+
+// Name of NPC n in a room
+std::string_view WorldGenerator::npc_name(int room, int n){
+	return person_in(room, n).name;
+}
+
+// Make a world from the options
+World WorldGenerator::generate(const GeneratorOptions& options){
+	if (options.rooms < 1 || options.exits < 2 || options.exits > count_of(DIRECTIONS)
+		|| options.itemsPerRoom < 0 || options.npcsPerRoom < 0 || options.messagesPerNPC < 1 || options.shopItems < 0){
+		throw std::invalid_argument("Generated worlds need at least 1 room, 2 to 10 exits per room, and at least 1 message per NPC.");
+	}
+	Random rng(options.seed);
+	World world;
+	std::string name; // Reused for each room's name
+	for (int r = 0; r < options.rooms; r++){
+		const Place& place = PLACES[rng.below(count_of(PLACES))];
+		name = ADJECTIVES[rng.below(count_of(ADJECTIVES))];
+		name += ' ';
+		name += place.name;
+		Location& room = world.locations.emplace_back(name, place.description);
+		for (int i = 0; i < options.itemsPerRoom; i++){
+			const Thing& thing = THINGS[rng.below(count_of(THINGS))];
+			room.emplace_item(world.items, thing.name, thing.description, thing.calories, thing.weight);
+		}
+		for (int n = 0; n < options.npcsPerRoom; n++){
+			const Person& person = person_in(r, n);
+			NPC& npc = room.emplace_npc(person.name, person.description);
+			for (int m = 0; m < options.messagesPerNPC; m++){
+				npc.addMessage(MESSAGES[rng.below(count_of(MESSAGES))]);
+			}
+		}
+		if (r == 0){
+			room.emplace_npc("Elf", "A strange and magical looking being. Perhaps they can help save the campus?")
+				.addMessage("I'm too hungry to help anyone. Bring me 500 calories of food.");
+		}
+		if (r % SELLER_SPACING == SELLER_SPACING / 2){
+			room.emplace_npc("Vending machine", "It's a vending machine with plenty of snacks. 25 coins a pop.")
+				.addMessage("The vending machine hums quietly.");
+		}
+	}
+	for (int s = 0; s < options.shopItems; s++){
+		const Thing& thing = THINGS[s % 8]; // The first eight things are food
+		world.shopItems.emplace_back(thing.name, thing.description, thing.calories, thing.weight);
+	}
+
+	// North and South around the ring, then the other exits to random rooms
+	int order[count_of(DIRECTIONS)];
+	for (int r = 0; r < options.rooms && options.rooms > 1; r++){
+		world.graph.add_edge(r, DIRECTIONS[0], (r + 1) % options.rooms);
+		world.graph.add_edge(r, DIRECTIONS[1], (r + options.rooms - 1) % options.rooms);
+		// Pick the other directions in a random order (a partial shuffle), so each is used once
+		for (int d = 2; d < count_of(DIRECTIONS); d++){
+			order[d] = d;
+		}
+		for (int e = 2; e < options.exits; e++){
+			int pick = e + rng.below(count_of(DIRECTIONS) - e);
+			std::swap(order[e], order[pick]);
+			int target = rng.below(options.rooms - 1);
+			if (target >= r){
+				target++; // Never back into the same room
+			}
+			world.graph.add_edge(r, DIRECTIONS[order[e]], target);
+		}
+	}
+	world.graph.build(options.rooms);
+	world.elfLocation = 0;
+	world.securityLocation = options.rooms / 2;
+	return world;
+}
@@ -0,0 +1,69 @@
+#ifndef __WORLDGENERATOR_H__ // INCLUDE GUARD
+#define __WORLDGENERATOR_H__
+
+#include <cstdint>
+#include <string_view>
+#include "World.h"
+
+/*
+ * Header file for WorldGenerator.cpp
+ * WorldGenerator makes worlds of any size from a seed, for testing
+ * how the game scales (the built-in campus only has nine rooms).
+ * The same options always make the same world.
+ *
+ * Every room gets a name and description from a small list of places,
+ * itemsPerRoom items and npcsPerRoom NPCs from lists of things and
+ * people (each NPC with messagesPerNPC messages), and exits to other rooms:
+ *  North leads to the next room and South to the one before, in a ring,
+ *  so every room can reach every other room, and the rest of the exits
+ *  (East, West, Up, Down, ...) lead to random rooms.
+ * The Elf is in room 0, and campus security is halfway around the ring.
+ * Every SELLER_SPACING rooms there is also a Vending machine to buy from.
+ * The text is string literals, so it takes no memory per room.
+ *
+ * The items of each room are added to the world's ItemStore room by
+ * room, so room r's items have the handles r * itemsPerRoom up to
+ * (r + 1) * itemsPerRoom - 1 (before anything moves), and the name of
+ * NPC n in room r is npc_name(r, n).
+ */
+
+// Settings for a generated world
+struct GeneratorOptions{
+	int rooms = 1000; // Number of rooms
+	int exits = 4; // Exits out of each room, from 2 (just the ring) to 10
+	int itemsPerRoom = 3; // Items lying in each room
+	int npcsPerRoom = 1; // NPCs in each room (not counting the Elf and the sellers)
+	int messagesPerNPC = 3; // Messages each NPC cycles through
+	int shopItems = 5; // Items that can be bought with the buy command
+	std::uint64_t seed = 1; // Seed for everything random about the world
+};
+
+class WorldGenerator{
+	public:
+		// Rooms between one Vending machine and the next
+		static const int SELLER_SPACING = 64;
+		/*
+		 * generate makes a world from the options.
+		 * Throws an invalid_argument exception if an option is out of range.
+		 *
+		 * Args:
+		 * The settings for the world.
+		 *
+		 * Returns:
+		 * The generated world.
+		 */
+		static World generate(const GeneratorOptions& options);
+		/*
+		 * npc_name gets the name of one of the NPCs the generator puts in a room.
+		 *
+		 * Args:
+		 * room, the index of the room
+		 * n, which of the room's NPCs, from 0 to npcsPerRoom - 1
+		 *
+		 * Returns:
+		 * The NPC's name.
+		 */
+		static std::string_view npc_name(int room, int n);
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "WorldGraph.h"
+#include "Location.h"
+#include "WorldState.h"
+#include "SymbolTable.h"
+#include <stdexcept>
+
+/*
+ * WorldGraph stores the directions between locations as
+ * compressed edge arrays indexed by location number.
+ * Includes functions to add and build edges, look up direction
+ * IDs and neighbors, and print the directions out of a location.
+ */
+
+// Record an edge to be built later
+void WorldGraph::add_edge(int from, std::string_view direction, int to){
+	if (direction.empty()){
+		throw std::invalid_argument("Direction string cannot be empty");
+	}
+	pendingFrom.push_back(from);
+	pendingDirection.push_back(SymbolTable::global().intern(direction));
+	pendingTarget.push_back(to);
+}
+
+// Build the compressed arrays from all the added edges
+void WorldGraph::build(int locationCount){
+	int edgeCount = pendingFrom.size();
+	std::shared_ptr<Edges> built = std::make_shared<Edges>();
+	std::vector<int>& edgeStart = built->edgeStart;
+	std::vector<int>& edgeDirection = built->edgeDirection;
+	std::vector<int>& edgeTarget = built->edgeTarget;
+	std::vector<int>& incomingStart = built->incomingStart;
+	std::vector<int>& incomingSource = built->incomingSource;
+	// Count the edges out of each location, then turn the counts into starting offsets
+	edgeStart.assign(locationCount + 1, 0);
+	for (int e = 0; e < edgeCount; e++){
+		if (pendingFrom[e] < 0 || pendingFrom[e] >= locationCount || pendingTarget[e] < 0 || pendingTarget[e] >= locationCount){
+			throw std::invalid_argument("Edge refers to a location that doesn't exist.");
+		}
+		edgeStart[pendingFrom[e] + 1]++;
+	}
+	for (int l = 0; l < locationCount; l++){
+		edgeStart[l + 1] += edgeStart[l];
+	}
+	// Place every edge in its location's section
+	edgeDirection.assign(edgeCount, 0);
+	edgeTarget.assign(edgeCount, 0);
+	std::vector<int> next(edgeStart.begin(), edgeStart.end() - 1);
+	for (int e = 0; e < edgeCount; e++){
+		int slot = next[pendingFrom[e]]++;
+		edgeDirection[slot] = pendingDirection[e];
+		edgeTarget[slot] = pendingTarget[e];
+	}
+	// Sort each location's edges by direction name (only a few per location, so insertion sort)
+	const SymbolTable& symbols = SymbolTable::global();
+	for (int l = 0; l < locationCount; l++){
+		for (int i = edgeStart[l] + 1; i < edgeStart[l + 1]; i++){
+			int direction = edgeDirection[i];
+			int target = edgeTarget[i];
+			int j = i;
+			while (j > edgeStart[l] && symbols.name(edgeDirection[j - 1]) > symbols.name(direction)){
+				edgeDirection[j] = edgeDirection[j - 1];
+				edgeTarget[j] = edgeTarget[j - 1];
+				j--;
+			}
+			edgeDirection[j] = direction;
+			edgeTarget[j] = target;
+		}
+		for (int i = edgeStart[l] + 1; i < edgeStart[l + 1]; i++){
+			if (edgeDirection[i] == edgeDirection[i - 1]){
+				throw std::invalid_argument("This direction is already a key in the map.");
+			}
+		}
+	}
+	// Reverse the edges the same way, by counting the edges into each location
+	incomingStart.assign(locationCount + 1, 0);
+	for (int e = 0; e < edgeCount; e++){
+		incomingStart[edgeTarget[e] + 1]++;
+	}
+	for (int l = 0; l < locationCount; l++){
+		incomingStart[l + 1] += incomingStart[l];
+	}
+	incomingSource.assign(edgeCount, 0);
+	next.assign(incomingStart.begin(), incomingStart.end() - 1);
+	for (int l = 0; l < locationCount; l++){
+		for (int e = edgeStart[l]; e < edgeStart[l + 1]; e++){
+			incomingSource[next[edgeTarget[e]]++] = l;
+		}
+	}
+	pendingFrom.clear();
+	pendingDirection.clear();
+	pendingTarget.clear();
+	edges = std::move(built);
+}
+
+// Get the ID for a direction name, or -1 if it was never interned
+int WorldGraph::direction_id(std::string_view direction) const{
+	return SymbolTable::global().lookup(direction);
+}
+
+// Get the location in the given direction, or -1 if there isn't one
+int WorldGraph::neighbor(int location, int direction) const{
+	for (int e = edges->edgeStart[location]; e < edges->edgeStart[location + 1]; e++){
+		if (edges->edgeDirection[e] == direction){
+			return edges->edgeTarget[e];
+		}
+	}
+	return -1;
+}
+
+int WorldGraph::edges_begin(int location) const{
+	return edges->edgeStart[location];
+}
+
+int WorldGraph::edges_end(int location) const{
+	return edges->edgeStart[location + 1];
+}
+
+int WorldGraph::edge_direction(int edge) const{
+	return edges->edgeDirection[edge];
+}
+
+int WorldGraph::edge_target(int edge) const{
+	return edges->edgeTarget[edge];
+}
+
+int WorldGraph::incoming_begin(int location) const{
+	return edges->incomingStart[location];
+}
+
+int WorldGraph::incoming_end(int location) const{
+	return edges->incomingStart[location + 1];
+}
+
+int WorldGraph::incoming_source(int edge) const{
+	return edges->incomingSource[edge];
+}
+
+const std::string& WorldGraph::direction_name(int direction) const{
+	return SymbolTable::global().name(direction);
+}
+
+int WorldGraph::location_count() const{
+	return edges ? edges->edgeStart.size() - 1 : 0;
+}
+
+// Print the directions out of a location, and the names of neighbors that have been visited
+void WorldGraph::print_directions(std::ostream& out, int location, const CowArray<Location>& locations, const WorldState& state) const{
+	const SymbolTable& symbols = SymbolTable::global();
+	out << "\nYou can go in the following Directions: ";
+	for (int e = edges->edgeStart[location]; e < edges->edgeStart[location + 1]; e++){
+		int neighbor = edges->edgeTarget[e];
+		// If location hasn't been visited, do not print the name - print unknown.
+		if (!state.visited(neighbor)){
+			out << "\n - " << symbols.name(edges->edgeDirection[e]) << " - " << "Unknown";
+		} else {
+			out << "\n - " << symbols.name(edges->edgeDirection[e]) << " - " << symbols.name(locations[neighbor].nameId) << " (Visited) ";
+		}
+	}
+	out << "\n";
+}
@@ -0,0 +1,123 @@
+#ifndef __WORLDGRAPH_H__ // INCLUDE GUARD
+#define __WORLDGRAPH_H__
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <memory>
+#include "CowArray.h"
+
+class Location;
+class WorldState;
+
+/*
+ * Header file for WorldGraph.cpp
+ * WorldGraph holds the connections between locations in the world.
+ * Locations are referred to by their index in the world's vector of
+ * locations, and directions (North, East, etc.) by the ID of their
+ * name in the global SymbolTable.
+ * Edges are stored in compressed (CSR) arrays: all the edges leaving
+ * a location sit next to each other, and edgeStart says where each
+ * location's edges begin. This means following a direction only looks
+ * at the few edges of the current location, no matter how big the world
+ * is, and the graph can be copied safely since it holds no references.
+ * The arrays never change once built, so copies of the graph (ex. in
+ * copies of a World) share them instead of copying them.
+ * The edges are also kept reversed (incomingStart), so the locations
+ * that lead into a location can be found just as quickly.
+ * Includes methods to add edges, build the arrays, look up directions
+ * and neighbors, and print the directions out of a location.
+ */
+
+class WorldGraph{
+	private:
+		// The built arrays. They never change once built, so copies of the graph share them
+		struct Edges{
+			std::vector<int> edgeStart; // Location index -> first edge; has one extra entry at the end
+			std::vector<int> edgeDirection; // Edge -> direction ID
+			std::vector<int> edgeTarget; // Edge -> index of the location it leads to
+			std::vector<int> incomingStart; // Location index -> first edge leading into it; has one extra entry at the end
+			std::vector<int> incomingSource; // Incoming edge -> index of the location it comes from
+		};
+		std::shared_ptr<const Edges> edges; // nullptr until build is called
+		// Edges that have been added but not built into the arrays yet (from, direction, to)
+		std::vector<int> pendingFrom;
+		std::vector<int> pendingDirection;
+		std::vector<int> pendingTarget;
+	public:
+		/*
+		 * add_edge records that going in the given direction from one location
+		 * leads to another. The edge is not usable until build() is called.
+		 *
+		 * Args:
+		 * from, the index of the location the edge starts at
+		 * direction, the name of the direction (ex. North)
+		 * to, the index of the location the edge leads to
+		 */
+		void add_edge(int from, std::string_view direction, int to);
+		/*
+		 * build turns all of the added edges into the compressed arrays.
+		 * Edges out of each location are sorted by direction name so they
+		 * print in alphabetical order.
+		 * Throws an invalid_argument exception if a location has the same
+		 * direction twice, or an edge refers to a location that doesn't exist.
+		 *
+		 * Args:
+		 * The number of locations in the world.
+		 */
+		void build(int locationCount);
+		/*
+		 * direction_id gets the ID of a direction name (its symbol ID).
+		 *
+		 * Args:
+		 * The name of the direction.
+		 *
+		 * Returns:
+		 * The direction ID, or -1 if the name was never interned.
+		 */
+		int direction_id(std::string_view direction) const;
+		/*
+		 * neighbor gets the location reached by going in a direction.
+		 *
+		 * Args:
+		 * location, the index of the location to start from
+		 * direction, the ID of the direction to go in
+		 *
+		 * Returns:
+		 * The index of the neighboring location, or -1 if there is no
+		 * edge in that direction.
+		 */
+		int neighbor(int location, int direction) const;
+		// Index of the first edge out of a location
+		int edges_begin(int location) const;
+		// Index one past the last edge out of a location
+		int edges_end(int location) const;
+		// Direction ID of an edge
+		int edge_direction(int edge) const;
+		// Index of the location an edge leads to
+		int edge_target(int edge) const;
+		// Index of the first edge leading into a location
+		int incoming_begin(int location) const;
+		// Index one past the last edge leading into a location
+		int incoming_end(int location) const;
+		// Index of the location an incoming edge comes from
+		int incoming_source(int edge) const;
+		// Name of a direction ID
+		const std::string& direction_name(int direction) const;
+		// Number of locations the graph was built for
+		int location_count() const;
+		/*
+		 * print_directions prints the directions you can go from a location.
+		 * Neighbors that haven't been visited yet are printed as Unknown.
+		 *
+		 * Args:
+		 * out, the output stream to write to
+		 * location, the index of the location
+		 * locations, the world's locations the indexes refer to
+		 * state, the game's state of the world, for which neighbors have been visited
+		 */
+		void print_directions(std::ostream& out, int location, const CowArray<Location>& locations, const WorldState& state) const;
+};
+
+#endif
@@ -0,0 +1,386 @@
+#include "WorldLoader.h"
+#include "SymbolTable.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+/*
+ * WorldLoader reads worlds from text world definitions
+ * and compiled binary world files, and writes worlds out
+ * in the compiled binary format.
+ */
+
+// Layout of a compiled binary world. All records are made of 4 byte fields,
+// so every section stays 4 byte aligned and can be read straight out of the mapping.
+static const char WORLD_MAGIC[8] = {'G', 'V', 'Z', 'W', 'O', 'R', 'L', 'D'};
+static const uint32_t WORLD_VERSION = 1;
+
+// A string in the string table
+struct StringRef{
+	uint32_t offset;
+	uint32_t length;
+};
+
+struct FileHeader{
+	char magic[8];
+	uint32_t version;
+	uint32_t locationCount;
+	uint32_t itemCount; // Items in locations, followed by shop items
+	uint32_t shopCount;
+	uint32_t npcCount;
+	uint32_t messageCount;
+	uint32_t edgeCount;
+	int32_t elfLocation;
+	int32_t securityLocation;
+	// Byte offsets of each section from the start of the file
+	uint32_t locationOffset;
+	uint32_t itemOffset;
+	uint32_t npcOffset;
+	uint32_t messageOffset;
+	uint32_t edgeOffset;
+	uint32_t stringOffset;
+	uint32_t stringSize;
+};
+
+struct LocationRecord{
+	StringRef name;
+	StringRef description;
+	uint32_t firstItem; // The location's items are itemCount records starting at firstItem
+	uint32_t itemCount;
+	uint32_t firstNpc; // The location's NPCs are npcCount records starting at firstNpc
+	uint32_t npcCount;
+};
+
+struct ItemRecord{
+	StringRef name;
+	StringRef description;
+	int32_t calories;
+	float weight;
+};
+
+struct NPCRecord{
+	StringRef name;
+	StringRef description;
+	uint32_t firstMessage; // The NPC's messages are messageCount strings starting at firstMessage
+	uint32_t messageCount;
+};
+
+struct EdgeRecord{
+	uint32_t from;
+	uint32_t to;
+	StringRef direction;
+};
+
+// Remove spaces and tabs from both ends of a string
+static std::string trim(const std::string& text){
+	std::size_t first = text.find_first_not_of(" \t\r");
+	if (first == std::string::npos){
+		return "";
+	}
+	std::size_t last = text.find_last_not_of(" \t\r");
+	return text.substr(first, last - first + 1);
+}
+
+// Read a world from a file in either format
+World WorldLoader::load_world(const std::string& path){
+	std::ifstream file(path, std::ios::binary);
+	if (!file){
+		throw std::invalid_argument("Could not open world file: " + path);
+	}
+	// Compiled worlds start with the magic bytes; anything else is read as text
+	char magic[sizeof(WORLD_MAGIC)] = {};
+	file.read(magic, sizeof(magic));
+	if (file.gcount() == sizeof(magic) && std::memcmp(magic, WORLD_MAGIC, sizeof(magic)) == 0){
+		return load_binary(path);
+	}
+	file.clear();
+	file.seekg(0);
+	return load_text(file);
+}
+
+// Read a world from the text world definition format
+World WorldLoader::load_text(std::istream& text){
+	World world;
+	TextArena& arena = *world.text; // Descriptions and messages are copied out of the line buffer into here
+	std::map<std::string, int> locationKeys; // Location key -> index in world.locations
+	// Exits and roles refer to location keys, which may be defined further down, so resolve them at the end
+	std::vector<std::vector<std::string>> exits;
+	std::vector<int> exitLines;
+	std::string elfKey;
+	std::string securityKey;
+	int elfLine = 0;
+	int securityLine = 0;
+	int npcLine = 0; // Line of the last NPC, until it has a message
+	// An NPC must have something to say, which it can only be given before the next NPC or location
+	auto check_npc_messages = [&npcLine](){
+		if (npcLine != 0){
+			throw std::invalid_argument("Line " + std::to_string(npcLine) + ": NPC has no messages.");
+		}
+	};
+	std::string line;
+	int lineNum = 0;
+	while (std::getline(text, line)){
+		lineNum++;
+		std::string trimmed = trim(line);
+		if (trimmed.empty() || trimmed[0] == '#'){
+			continue;
+		}
+		// Split the line into its fields
+		std::vector<std::string> fields;
+		std::stringstream lineStream(trimmed);
+		std::string field;
+		while (std::getline(lineStream, field, '|')){
+			fields.push_back(trim(field));
+		}
+		const std::string& keyword = fields[0];
+		if (keyword == "location" || keyword == "npc"){
+			check_npc_messages();
+		}
+		try {
+			if (keyword == "location" && fields.size() == 4){
+				if (locationKeys.count(fields[1])){
+					throw std::invalid_argument("Location key " + fields[1] + " is used twice.");
+				}
+				locationKeys[fields[1]] = world.locations.size();
+				world.locations.emplace_back(fields[2], arena.copy(fields[3]));
+			} else if ((keyword == "item" || keyword == "shop") && fields.size() == 5){
+				Item item(fields[1], arena.copy(fields[2]), std::stoi(fields[3]), std::stof(fields[4]));
+				if (keyword == "shop"){
+					world.shopItems.push_back(item);
+				} else if (world.locations.empty()){
+					throw std::invalid_argument("Item comes before any location.");
+				} else {
+					world.locations.back().add_item(item, world.items);
+				}
+			} else if (keyword == "npc" && fields.size() == 3){
+				if (world.locations.empty()){
+					throw std::invalid_argument("NPC comes before any location.");
+				}
+				world.locations.back().emplace_npc(fields[1], arena.copy(fields[2]));
+				npcLine = lineNum;
+			} else if (keyword == "message" && fields.size() == 2){
+				if (world.locations.empty() || world.locations.back().locationNPCs.empty()){
+					throw std::invalid_argument("Message comes before any NPC in this location.");
+				}
+				world.locations.back().locationNPCs.back().addMessage(arena.copy(fields[1]));
+				npcLine = 0;
+			} else if (keyword == "exit" && fields.size() == 4){
+				exits.push_back(fields);
+				exitLines.push_back(lineNum);
+			} else if (keyword == "elf" && fields.size() == 2){
+				elfKey = fields[1];
+				elfLine = lineNum;
+			} else if (keyword == "security" && fields.size() == 2){
+				securityKey = fields[1];
+				securityLine = lineNum;
+			} else {
+				throw std::invalid_argument("Unknown entry or wrong number of fields.");
+			}
+		} catch (const std::invalid_argument& e){
+			throw std::invalid_argument("Line " + std::to_string(lineNum) + ": " + e.what());
+		} catch (const std::out_of_range& e){
+			throw std::invalid_argument("Line " + std::to_string(lineNum) + ": Number is out of range.");
+		}
+	}
+	check_npc_messages();
+	if (world.locations.empty()){
+		throw std::invalid_argument("World has no locations.");
+	}
+	// Look up a location key, with the line it came from for the error message
+	auto find_location = [&locationKeys](const std::string& key, int lineNum){
+		auto it = locationKeys.find(key);
+		if (it == locationKeys.end()){
+			throw std::invalid_argument("Line " + std::to_string(lineNum) + ": Unknown location key " + key + ".");
+		}
+		return it->second;
+	};
+	for (std::size_t e = 0; e < exits.size(); e++){
+		world.graph.add_edge(find_location(exits[e][1], exitLines[e]), exits[e][2], find_location(exits[e][3], exitLines[e]));
+	}
+	world.graph.build(world.locations.size());
+	// The roles default to the first location if they weren't given
+	world.elfLocation = elfKey.empty() ? 0 : find_location(elfKey, elfLine);
+	world.securityLocation = securityKey.empty() ? 0 : find_location(securityKey, securityLine);
+	return world;
+}
+
+// Read a compiled binary world in place from a memory-mapped file
+World WorldLoader::load_binary(const std::string& path){
+	World world;
+	// The file stays mapped in the world's arena, so descriptions and messages point straight into it
+	std::string_view file = world.text->map(path);
+	const char* base = file.data();
+	std::size_t size = file.size();
+	if (size < sizeof(FileHeader)){
+		throw std::invalid_argument("World file is too small: " + path);
+	}
+	const FileHeader* header = reinterpret_cast<const FileHeader*>(base);
+	if (std::memcmp(header->magic, WORLD_MAGIC, sizeof(WORLD_MAGIC)) != 0){
+		throw std::invalid_argument("Not a compiled world file: " + path);
+	}
+	if (header->version != WORLD_VERSION){
+		throw std::invalid_argument("Compiled world file is version " + std::to_string(header->version) + ", expected " + std::to_string(WORLD_VERSION) + ".");
+	}
+	// Make sure every section is inside the file before reading any of it
+	auto check_section = [size](uint64_t offset, uint64_t count, uint64_t recordSize){
+		if (offset % 4 != 0 || offset > size || count * recordSize > size - offset){
+			throw std::invalid_argument("Compiled world file is truncated or corrupt.");
+		}
+	};
+	check_section(header->locationOffset, header->locationCount, sizeof(LocationRecord));
+	check_section(header->itemOffset, header->itemCount, sizeof(ItemRecord));
+	check_section(header->npcOffset, header->npcCount, sizeof(NPCRecord));
+	check_section(header->messageOffset, header->messageCount, sizeof(StringRef));
+	check_section(header->edgeOffset, header->edgeCount, sizeof(EdgeRecord));
+	check_section(header->stringOffset, header->stringSize, 1);
+	const LocationRecord* locations = reinterpret_cast<const LocationRecord*>(base + header->locationOffset);
+	const ItemRecord* items = reinterpret_cast<const ItemRecord*>(base + header->itemOffset);
+	const NPCRecord* npcs = reinterpret_cast<const NPCRecord*>(base + header->npcOffset);
+	const StringRef* messages = reinterpret_cast<const StringRef*>(base + header->messageOffset);
+	const EdgeRecord* edges = reinterpret_cast<const EdgeRecord*>(base + header->edgeOffset);
+	const char* strings = base + header->stringOffset;
+	uint32_t stringSize = header->stringSize;
+	// Get a string out of the string table, checking it's inside the table. The view is valid
+	// for as long as the world's arena (which holds the mapping) exists.
+	auto text = [strings, stringSize](const StringRef& ref){
+		if (ref.offset > stringSize || ref.length > stringSize - ref.offset){
+			throw std::invalid_argument("Compiled world file has a bad string reference.");
+		}
+		return std::string_view(strings + ref.offset, ref.length);
+	};
+	auto check_range = [](uint32_t first, uint32_t count, uint32_t total){
+		if (first > total || count > total - first){
+			throw std::invalid_argument("Compiled world file has a bad record range.");
+		}
+	};
+	auto make_item = [&text](const ItemRecord& record){
+		return Item(text(record.name), text(record.description), record.calories, record.weight);
+	};
+
+	if (header->locationCount == 0 || header->shopCount > header->itemCount){
+		throw std::invalid_argument("Compiled world file is truncated or corrupt.");
+	}
+	for (uint32_t l = 0; l < header->locationCount; l++){
+		const LocationRecord& record = locations[l];
+		Location& location = world.locations.emplace_back(text(record.name), text(record.description));
+		check_range(record.firstItem, record.itemCount, header->itemCount - header->shopCount);
+		for (uint32_t i = 0; i < record.itemCount; i++){
+			location.add_item(make_item(items[record.firstItem + i]), world.items);
+		}
+		check_range(record.firstNpc, record.npcCount, header->npcCount);
+		for (uint32_t n = 0; n < record.npcCount; n++){
+			const NPCRecord& npcRecord = npcs[record.firstNpc + n];
+			NPC& npc = location.emplace_npc(text(npcRecord.name), text(npcRecord.description));
+			check_range(npcRecord.firstMessage, npcRecord.messageCount, header->messageCount);
+			if (npcRecord.messageCount == 0){
+				throw std::invalid_argument("Compiled world file's NPC " + std::to_string(record.firstNpc + n) + " has no messages.");
+			}
+			for (uint32_t m = 0; m < npcRecord.messageCount; m++){
+				npc.addMessage(text(messages[npcRecord.firstMessage + m]));
+			}
+		}
+	}
+	// Shop items come after all the location items
+	for (uint32_t i = header->itemCount - header->shopCount; i < header->itemCount; i++){
+		world.shopItems.emplace_back(make_item(items[i]));
+	}
+	for (uint32_t e = 0; e < header->edgeCount; e++){
+		world.graph.add_edge(edges[e].from, text(edges[e].direction), edges[e].to);
+	}
+	world.graph.build(header->locationCount);
+	if (header->elfLocation < 0 || static_cast<uint32_t>(header->elfLocation) >= header->locationCount || header->securityLocation < 0 || static_cast<uint32_t>(header->securityLocation) >= header->locationCount){
+		throw std::invalid_argument("Compiled world file has a bad location index.");
+	}
+	world.elfLocation = header->elfLocation;
+	world.securityLocation = header->securityLocation;
+	return world;
+}
+
+// Write a world out in the compiled binary format
+void WorldLoader::compile_world(const World& world, const std::string& path){
+	std::string strings; // The string table
+	std::map<std::string, StringRef, std::less<>> stringRefs; // Strings already in the table, so repeats are only stored once
+	auto add_string = [&strings, &stringRefs](std::string_view text){
+		auto it = stringRefs.find(text);
+		if (it != stringRefs.end()){
+			return it->second;
+		}
+		StringRef ref{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size())};
+		strings += text;
+		stringRefs.emplace(std::string(text), ref);
+		return ref;
+	};
+	const SymbolTable& symbols = SymbolTable::global();
+	auto make_item = [&add_string, &symbols](const Item& item){
+		return ItemRecord{add_string(symbols.name(item.nameId)), add_string(item.description), item.calories, item.weight};
+	};
+	auto make_stored_item = [&add_string, &symbols, &world](ItemHandle item){
+		return ItemRecord{add_string(symbols.name(world.items.name_id(item))), add_string(world.items.description(item)), world.items.calories(item), world.items.weight(item)};
+	};
+
+	std::vector<LocationRecord> locations;
+	std::vector<ItemRecord> items;
+	std::vector<NPCRecord> npcs;
+	std::vector<StringRef> messages;
+	std::vector<EdgeRecord> edges;
+	for (int l = 0; l < world.locations.size(); l++){
+		const Location& location = world.locations[l];
+		LocationRecord record{add_string(symbols.name(location.nameId)), add_string(location.description), static_cast<uint32_t>(items.size()), static_cast<uint32_t>(location.locationItems.size()), static_cast<uint32_t>(npcs.size()), static_cast<uint32_t>(location.locationNPCs.size())};
+		locations.push_back(record);
+		for (ItemHandle item : location.locationItems){
+			items.push_back(make_stored_item(item));
+		}
+		for (const NPC& npc : location.locationNPCs){
+			npcs.push_back(NPCRecord{add_string(symbols.name(npc.nameId)), add_string(npc.description), static_cast<uint32_t>(messages.size()), static_cast<uint32_t>(npc.messages.size())});
+			for (std::string_view message : npc.messages){
+				messages.push_back(add_string(message));
+			}
+		}
+		for (int e = world.graph.edges_begin(l); e < world.graph.edges_end(l); e++){
+			edges.push_back(EdgeRecord{static_cast<uint32_t>(l), static_cast<uint32_t>(world.graph.edge_target(e)), add_string(world.graph.direction_name(world.graph.edge_direction(e)))});
+		}
+	}
+	for (const Item& item : world.shopItems){
+		items.push_back(make_item(item));
+	}
+
+	FileHeader header{};
+	std::memcpy(header.magic, WORLD_MAGIC, sizeof(WORLD_MAGIC));
+	header.version = WORLD_VERSION;
+	header.locationCount = locations.size();
+	header.itemCount = items.size();
+	header.shopCount = world.shopItems.size();
+	header.npcCount = npcs.size();
+	header.messageCount = messages.size();
+	header.edgeCount = edges.size();
+	header.elfLocation = world.elfLocation;
+	header.securityLocation = world.securityLocation;
+	header.locationOffset = sizeof(FileHeader);
+	header.itemOffset = header.locationOffset + locations.size() * sizeof(LocationRecord);
+	header.npcOffset = header.itemOffset + items.size() * sizeof(ItemRecord);
+	header.messageOffset = header.npcOffset + npcs.size() * sizeof(NPCRecord);
+	header.edgeOffset = header.messageOffset + messages.size() * sizeof(StringRef);
+	header.stringOffset = header.edgeOffset + edges.size() * sizeof(EdgeRecord);
+	header.stringSize = strings.size();
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file){
+		throw std::invalid_argument("Could not write world file: " + path);
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(locations.data()), locations.size() * sizeof(LocationRecord));
+	file.write(reinterpret_cast<const char*>(items.data()), items.size() * sizeof(ItemRecord));
+	file.write(reinterpret_cast<const char*>(npcs.data()), npcs.size() * sizeof(NPCRecord));
+	file.write(reinterpret_cast<const char*>(messages.data()), messages.size() * sizeof(StringRef));
+	file.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(EdgeRecord));
+	file.write(strings.data(), strings.size());
+	if (!file){
+		throw std::invalid_argument("Could not write world file: " + path);
+	}
+}
@@ -0,0 +1,86 @@
+#ifndef __WORLDLOADER_H__ // INCLUDE GUARD
+#define __WORLDLOADER_H__
+
+#include <string>
+#include <iostream>
+#include "World.h"
+
+/*
+ * Header file for WorldLoader.cpp
+ * WorldLoader reads worlds from files, so the game can be played
+ * in worlds other than the one built into Game::create_world
+ * without recompiling. Two formats are supported:
+ *
+ * A text world definition, one entry per line, with fields split by "|":
+ *   location | <key> | <name> | <description>
+ *   item | <name> | <description> | <calories> | <weight>   (added to the last location)
+ *   npc | <name> | <description>                            (added to the last location)
+ *   message | <text>                                        (added to the last NPC, which needs at least one)
+ *   shop | <name> | <description> | <calories> | <weight>   (can be bought with the buy command)
+ *   exit | <from key> | <direction> | <to key>
+ *   elf | <key>                                             (where the Elf is fed)
+ *   security | <key>                                        (where you're taken when caught stealing)
+ * Blank lines and lines starting with # are skipped.
+ *
+ * A compiled binary world, made from any World by compile_world.
+ * It is a header followed by fixed-size records (locations, items,
+ * NPCs, messages, and edges) and a single table of all the strings.
+ * Records refer to strings by offset and length into the table, so
+ * the file is memory-mapped and read in place, without parsing.
+ */
+
+class WorldLoader{
+	public:
+		/*
+		 * load_world reads a world from a file, either a text world
+		 * definition or a compiled binary world (detected from the
+		 * start of the file).
+		 * Throws an invalid_argument exception if the file can't be
+		 * read or isn't a valid world.
+		 *
+		 * Args:
+		 * The path of the world file.
+		 *
+		 * Returns:
+		 * The world read from the file.
+		 */
+		static World load_world(const std::string& path);
+		/*
+		 * load_text reads a world from a text world definition.
+		 * Throws an invalid_argument exception with the line number
+		 * if a line isn't valid.
+		 *
+		 * Args:
+		 * A stream holding the text world definition.
+		 *
+		 * Returns:
+		 * The world described by the text.
+		 */
+		static World load_text(std::istream& text);
+		/*
+		 * load_binary reads a compiled binary world by memory-mapping
+		 * the file and reading the records in place. The file stays
+		 * mapped in the world's TextArena, and the descriptions and
+		 * messages are views into it, so no text is copied.
+		 * Throws an invalid_argument exception if the file isn't a
+		 * valid compiled world of the current version.
+		 *
+		 * Args:
+		 * The path of the compiled world file.
+		 *
+		 * Returns:
+		 * The world stored in the file.
+		 */
+		static World load_binary(const std::string& path);
+		/*
+		 * compile_world writes a world out in the compiled binary format.
+		 * Throws an invalid_argument exception if the file can't be written.
+		 *
+		 * Args:
+		 * world, the world to write out
+		 * path, the path of the file to write
+		 */
+		static void compile_world(const World& world, const std::string& path);
+};
+
+#endif
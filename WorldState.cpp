@@ -0,0 +1,136 @@
+#include "WorldState.h"
+#include "WorldDefinition.h"
+#include "OutputSink.h"
+#include "SymbolTable.h"
+#include <utility> // For std::as_const
+
+/*
+ * WorldState holds what a game has changed about its world,
+ * and moves items between the rooms and an inventory.
+ * Reads go through a const view of the arrays, so they
+ * don't copy anything the state shares with other games.
+ */
+
+WorldState::WorldState() : shopItemsSold(0){
+}
+
+void WorldState::index_new_item(RoomState& room, const ItemStore& store){
+	if (room.itemIndex.built()){
+		room.itemIndex.push_back(store.name_id(room.items.back()));
+	} else {
+		rebuild_item_index(room, store);
+	}
+}
+
+void WorldState::rebuild_item_index(RoomState& room, const ItemStore& store){
+	if (room.items.size() <= Location::INDEX_THRESHOLD){
+		room.itemIndex = NameIndex();
+		return;
+	}
+	std::vector<int> names;
+	for (ItemHandle item : room.items){
+		names.push_back(store.name_id(item));
+	}
+	room.itemIndex.build(names);
+}
+
+bool WorldState::visited(int location) const{
+	return rooms[location].visited;
+}
+
+// Mark a location visited. The look text of its neighbors notices by itself (see render)
+void WorldState::set_visited(int location){
+	if (!std::as_const(rooms)[location].visited){
+		rooms[location].visited = true;
+	}
+}
+
+const std::vector<ItemHandle>& WorldState::items(int location) const{
+	return rooms[location].items;
+}
+
+// Look the name up in the index, or scan the items if the room doesn't have one
+int WorldState::find_item(int location, int nameId, const ItemStore& store) const{
+	const RoomState& room = rooms[location];
+	if (room.itemIndex.built()){
+		return room.itemIndex.find(nameId);
+	}
+	for (int i = 0; i < static_cast<int>(room.items.size()); i++){
+		if (store.name_id(room.items[i]) == nameId){
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Move an item into the inventory. The slots move the last item into its place, and so does the index
+void WorldState::take_item(int location, int slot, const ItemStore& store, Inventory& inventory){
+	RoomState& room = rooms[location];
+	if (room.itemIndex.built()){
+		room.itemIndex.swap_remove(slot);
+	}
+	inventory.take(store, slots, room.items, slot);
+	room.lookDirty = true;
+}
+
+// Move an item from the inventory to the back of the room's items
+void WorldState::drop_item(int location, const ItemStore& store, Inventory& inventory, int slot){
+	RoomState& room = rooms[location];
+	inventory.give(store, slots, slot, room.items);
+	index_new_item(room, store);
+	room.lookDirty = true;
+}
+
+// Claim the next item, unless another player claimed it first
+int WorldState::sell_shop_item(int shopCount){
+	int sold = shopItemsSold;
+	do {
+		if (sold >= shopCount){
+			return -1;
+		}
+	} while (!shopItemsSold.compare_exchange(sold, sold + 1));
+	return sold;
+}
+
+// Bytes the scratch sink starts with, enough for the look text of most rooms
+static const std::size_t SCRATCH_SIZE = 4096;
+// What a visited neighbor's line has on top of its name, against the line for one
+// that isn't (" (Visited) " instead of "Unknown"), rounded up
+static const std::size_t VISITED_GROWTH = 8;
+
+// Format the look text again if something changed, otherwise reuse it. Visited
+// flags only ever get set while playing, so a neighbor has been visited since
+// the last render exactly when the count of visited neighbors went up.
+const std::string& WorldState::render(int location, const WorldDefinition& world){
+	const RoomState& current = std::as_const(rooms)[location];
+	int visitedNeighbors = 0;
+	for (int e = world.graph.edges_begin(location); e < world.graph.edges_end(location); e++){
+		visitedNeighbors += visited(world.graph.edge_target(e));
+	}
+	if (!current.lookDirty && current.lookVisitedNeighbors == visitedNeighbors){
+		return current.lookText;
+	}
+	// One scratch sink per thread, since games can run on many threads at once
+	thread_local MemorySink scratch;
+	scratch.clear();
+	scratch.reserve(SCRATCH_SIZE);
+	world.locations[location].print(scratch.stream(), current.items, world.items);
+	world.graph.print_directions(scratch.stream(), location, world.locations, *this);
+	scratch.stream() << "\n";
+	RoomState& room = rooms[location];
+	const std::string& text = scratch.str();
+	// When the text doesn't fit, make room for every neighbor's name too, so it
+	// doesn't need more memory again as the neighbors get visited
+	if (room.lookText.capacity() < text.size()){
+		const SymbolTable& symbols = SymbolTable::global();
+		std::size_t growth = 0;
+		for (int e = world.graph.edges_begin(location); e < world.graph.edges_end(location); e++){
+			growth += symbols.name(world.locations[world.graph.edge_target(e)].nameId).size() + VISITED_GROWTH;
+		}
+		room.lookText.reserve(text.size() + growth);
+	}
+	room.lookText.assign(text); // Reuses lookText's memory, which is big enough now
+	room.lookDirty = false;
+	room.lookVisitedNeighbors = visitedNeighbors;
+	return room.lookText;
+}
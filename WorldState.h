@@ -0,0 +1,176 @@
+#ifndef __WORLDSTATE_H__ // INCLUDE GUARD
+#define __WORLDSTATE_H__
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "ItemStore.h"
+#include "Inventory.h"
+#include "NameIndex.h"
+#include "CowArray.h"
+
+class WorldDefinition;
+
+/*
+ * Header file for WorldState.cpp
+ * WorldState is everything about a world that changes while a game is
+ * played: which locations have been visited, the items in each location
+ * (and where every item is, see ItemSlots), each NPC's message number
+ * and robbed flag, and how many shop items have been sold. Everything
+ * that doesn't change (names, descriptions, messages, exits) is in the
+ * WorldDefinition, which every game in the world shares.
+ *
+ * A game's state starts as a copy of its definition's starting state.
+ * The arrays are CowArrays, so the copy shares everything with the start
+ * until the game changes something, and then only copies the leaf of
+ * rooms or NPCs holding what changed. So a game costs memory for the
+ * parts of the world it has changed, however big the world is.
+ *
+ * The text printed by look is cached in each room's state, and only
+ * rendered again once something it shows has changed (see render).
+ * Visiting a room changes the look text of the rooms leading into it,
+ * but they aren't marked: render counts a room's visited neighbors
+ * instead, so moving only ever writes the state of the room moved from
+ * (marking them would copy their leaves too, wherever they are).
+ * Rooms with more than Location::INDEX_THRESHOLD items keep a NameIndex
+ * of them, the same way crowded rooms do for their NPCs.
+ */
+
+/*
+ * RelaxedAtomic holds a value that players sharing one WorldState (see
+ * SharedWorld.h) read without holding the lock of the room it belongs to,
+ * like the visited flags of a room's neighbors. Loads and stores are
+ * relaxed atomics, which are plain moves on common CPUs, so a game with a
+ * state to itself pays nothing for them. Copying copies the value, so the
+ * state stays copyable.
+ */
+template <typename T>
+class RelaxedAtomic{
+	private:
+		std::atomic<T> value;
+	public:
+		RelaxedAtomic(T value = T()) : value(value){
+		}
+		RelaxedAtomic(const RelaxedAtomic& other) : value(other.value.load(std::memory_order_relaxed)){
+		}
+		RelaxedAtomic& operator=(const RelaxedAtomic& other){
+			value.store(other.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			return *this;
+		}
+		RelaxedAtomic& operator=(T newValue){
+			value.store(newValue, std::memory_order_relaxed);
+			return *this;
+		}
+		operator T() const{
+			return value.load(std::memory_order_relaxed);
+		}
+		// Set the value to desired if it is still expected; otherwise expected gets the value
+		bool compare_exchange(T& expected, T desired){
+			return value.compare_exchange_weak(expected, desired, std::memory_order_relaxed);
+		}
+};
+
+// What changes about a location while a game is played
+struct RoomState{
+	RelaxedAtomic<bool> visited = false; // Whether the player has been here (any player, in a SharedWorld)
+	bool lookDirty = true; // Set when the items change, so lookText is out of date
+	int lookVisitedNeighbors = 0; // Neighbors that had been visited when lookText was rendered
+	std::vector<ItemHandle> items; // Handles of the Items in the location now, in the world's ItemStore
+	NameIndex itemIndex; // Name -> position in items, only built for crowded rooms
+	std::string lookText; // What look printed last time, reused until lookDirty is set or another neighbor is visited; has room for the neighbors' names
+};
+
+// What changes about an NPC while a game is played
+struct NPCState{
+	int messageNum = 0; // Index for what message the NPC is on
+	bool robbed = false; // Whether the NPC has been stolen from yet (can only steal from each NPC once)
+};
+
+class WorldState{
+	private:
+		CowArray<RoomState> rooms; // One per location, by location index
+		CowArray<NPCState, 64> npcs; // One per NPC, numbered in location order (see WorldDefinition::npc_number)
+		ItemSlots slots; // Where each item in the world's ItemStore is
+		RelaxedAtomic<int> shopItemsSold; // Shop items are sold in order, and this many have been
+		// Keep a room's item index up to date after adding an item, building it once the room gets crowded
+		static void index_new_item(RoomState& room, const ItemStore& store);
+		// Index a room's items from scratch, or drop the index if the room isn't crowded
+		static void rebuild_item_index(RoomState& room, const ItemStore& store);
+		// Friend of Game, Simulator, Snapshot, WorldDefinition, SharedWorld, and EventReplayer so they can access the state without getters and setters
+		friend class Game;
+		friend class Simulator;
+		friend class Snapshot;
+		friend class WorldDefinition;
+		friend class SharedWorld;
+		friend class EventReplayer;
+	public:
+		// Constructor, for a world with nothing in it (WorldDefinition makes the starting state)
+		WorldState();
+		// Whether a location has been visited
+		bool visited(int location) const;
+		// Mark a location visited
+		void set_visited(int location);
+		// The handles of the items in a location now
+		const std::vector<ItemHandle>& items(int location) const;
+		/*
+		 * find_item finds an item in a location by name.
+		 *
+		 * Args:
+		 * location, the index of the location
+		 * nameId, the ID of the name in the global SymbolTable (-1 never matches)
+		 * store, the world's item store
+		 *
+		 * Returns:
+		 * The item's slot in the location's items, or -1 if there's no item with that name.
+		 */
+		int find_item(int location, int nameId, const ItemStore& store) const;
+		/*
+		 * take_item moves an item from a location into an inventory.
+		 *
+		 * Args:
+		 * location, the index of the location
+		 * slot, the item's slot in the location (ex. from find_item)
+		 * store, the world's item store
+		 * inventory, the inventory to move it to
+		 */
+		void take_item(int location, int slot, const ItemStore& store, Inventory& inventory);
+		/*
+		 * drop_item moves an item from an inventory into a location.
+		 *
+		 * Args:
+		 * location, the index of the location
+		 * store, the world's item store
+		 * inventory, the inventory to move it from
+		 * slot, the item's slot in the inventory
+		 */
+		void drop_item(int location, const ItemStore& store, Inventory& inventory, int slot);
+		/*
+		 * sell_shop_item sells the next shop item, if there are any left.
+		 * Players in a SharedWorld can buy at the same time (in different
+		 * shops), so the next item is claimed atomically.
+		 *
+		 * Args:
+		 * The number of shop items in the world.
+		 *
+		 * Returns:
+		 * How many shop items had been sold before this one (so the sold item is the
+		 * shop item with that number), or -1 if they're all sold.
+		 */
+		int sell_shop_item(int shopCount);
+		/*
+		 * render gets the text that look prints for a location: the
+		 * location itself followed by the directions out of it. The text
+		 * is only formatted again if the location was changed since the
+		 * last call; otherwise the cached copy is returned as is.
+		 *
+		 * Args:
+		 * location, the index of the location
+		 * world, the world this is the state of
+		 *
+		 * Returns:
+		 * A reference to the text, valid until the state changes.
+		 */
+		const std::string& render(int location, const WorldDefinition& world);
+};
+
+#endif
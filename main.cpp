@@ -1,23 +1,84 @@
 #include <iostream>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
 #include "NPC.h"
 #include "Item.h"
 #include "Location.h"
 #include "Game.h"
+#include "WorldLoader.h"
+#include "WorldGenerator.h"
+#include "OutputSink.h"
+#include <unistd.h> // For STDOUT_FILENO
 
 /*
  * Main method to run the GVZork game!
  *
+ * Usage:
+ * GVZork [--world <file>] [--seed N]
+ *  --world <file>  play in a world read from a text or compiled world file
+ *  --seed N        seed the random number generator, so the game can be repeated
+ * GVZork --compile-world <in> <out>
+ *  reads the world file <in> and writes it to <out> in the compiled binary format
+ * GVZork --generate-world <rooms> <out>
+ *  generates a world with the given number of rooms (see WorldGenerator.h)
+ *  and writes it to <out> in the compiled binary format
+ *
  * Author: Breanna Zinky
  * Date: 10/6/2023
  *
  */
 
 int main(int argc, char** argv){
+	std::string worldPath;
+	std::uint64_t seed = Random::random_seed();
+	for (int a = 1; a < argc; a++){
+		std::string arg = argv[a];
+		if (arg == "--world" && a + 1 < argc){
+			worldPath = argv[++a];
+		} else if (arg == "--seed" && a + 1 < argc){
+			seed = std::stoull(argv[++a]);
+		} else if (arg == "--compile-world" && a + 2 < argc){
+			// Compile a world file and exit without playing
+			try {
+				WorldLoader::compile_world(WorldLoader::load_world(argv[a + 1]), argv[a + 2]);
+			} catch (const std::invalid_argument& e){
+				std::cerr << e.what() << std::endl;
+				return 1;
+			}
+			return 0;
+		} else if (arg == "--generate-world" && a + 2 < argc){
+			// Generate a world for scale testing and exit without playing
+			try {
+				GeneratorOptions options;
+				options.rooms = std::stoi(argv[a + 1]);
+				WorldLoader::compile_world(WorldGenerator::generate(options), argv[a + 2]);
+			} catch (const std::exception& e){
+				std::cerr << e.what() << std::endl;
+				return 1;
+			}
+			return 0;
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--world <file>] [--seed N] | --compile-world <in> <out> | --generate-world <rooms> <out>" << std::endl;
+			return 2;
+		}
+	}
+
+	// Read in the world to play in, or use the built-in one
+	World world;
+	try {
+		world = worldPath.empty() ? Game::create_world() : WorldLoader::load_world(worldPath);
+	} catch (const std::invalid_argument& e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	// Game output is buffered and written out once per turn
+	BufferedSink output(STDOUT_FILENO);
 	// Create the game instance
-	Game newGame;
+	Game newGame(std::move(world), seed, output.stream());
 	// Run the play method (core game loop) on the game instance
 	newGame.play();
 
-	std::cout << "\nThanks for playing!\n";
+	output.stream() << "\nThanks for playing!\n" << std::flush;
 	return 0;
 }